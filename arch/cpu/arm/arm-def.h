@@ -58,6 +58,12 @@ typedef uint32_t clock_time_t;
 typedef uint32_t uip_stats_t;
 
 /** @} */
+/*---------------------------------------------------------------------------*/
+/* 32-bit CPUs: sum whole words for the Internet checksum */
+#ifndef UIP_CONF_CHKSUM_WIDE
+#define UIP_CONF_CHKSUM_WIDE 1
+#endif /* UIP_CONF_CHKSUM_WIDE */
+/*---------------------------------------------------------------------------*/
 
 /*
  * The stdio.h that ships with the arm-gcc toolchain does this:
@@ -33,35 +33,74 @@
 #include "sys/int-master.h"
 
 #include <stdbool.h>
+#ifndef _WIN32
+#include <signal.h>
+#endif /* !_WIN32 */
 /*---------------------------------------------------------------------------*/
 #define DISABLED 0
 #define ENABLED  1
 /*---------------------------------------------------------------------------*/
+#ifndef _WIN32
+/* The interrupts of the native platform are signals, SIGALRM in
+   particular, whose handler runs the rtimer tasks. The master interrupt
+   is disabled by blocking SIGALRM, and its status is read from the
+   signal mask: SIGALRM is also blocked while its handler runs. */
+static int_master_status_t
+mask_sigalrm(int how)
+{
+  sigset_t set, old;
+
+  sigemptyset(&set);
+  sigaddset(&set, SIGALRM);
+  sigprocmask(how, &set, &old);
+  return sigismember(&old, SIGALRM) ? DISABLED : ENABLED;
+}
+#else /* !_WIN32 */
 static int_master_status_t stat = DISABLED;
+#endif /* !_WIN32 */
 /*---------------------------------------------------------------------------*/
 void
 int_master_enable(void)
 {
+#ifndef _WIN32
+  mask_sigalrm(SIG_UNBLOCK);
+#else /* !_WIN32 */
   stat = ENABLED;
+#endif /* !_WIN32 */
 }
 /*---------------------------------------------------------------------------*/
 int_master_status_t
 int_master_read_and_disable(void)
 {
+#ifndef _WIN32
+  return mask_sigalrm(SIG_BLOCK);
+#else /* !_WIN32 */
   int_master_status_t rv = stat;
   stat = DISABLED;
   return rv;
+#endif /* !_WIN32 */
 }
 /*---------------------------------------------------------------------------*/
 void
 int_master_status_set(int_master_status_t status)
 {
+#ifndef _WIN32
+  mask_sigalrm(status == DISABLED ? SIG_BLOCK : SIG_UNBLOCK);
+#else /* !_WIN32 */
   stat = status;
+#endif /* !_WIN32 */
 }
 /*---------------------------------------------------------------------------*/
 bool
 int_master_is_enabled(void)
 {
+#ifndef _WIN32
+  sigset_t old;
+
+  sigprocmask(SIG_BLOCK, NULL, &old);
+  return !sigismember(&old, SIGALRM);
+#else /* !_WIN32 */
   return stat == DISABLED ? false : true;
+#endif /* !_WIN32 */
 }
 /*---------------------------------------------------------------------------*/
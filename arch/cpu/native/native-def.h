@@ -34,5 +34,8 @@
 /*---------------------------------------------------------------------------*/
 #define GPIO_HAL_CONF_ARCH_SW_TOGGLE 1
 /*---------------------------------------------------------------------------*/
+/* Native code may hand data to other threads (e.g. through lib/spsc-ringbuf) */
+#define memory_barrier() __sync_synchronize()
+/*---------------------------------------------------------------------------*/
 #endif /* NATIVE_DEF_H_ */
 /*---------------------------------------------------------------------------*/
@@ -54,11 +54,14 @@
 #define PRINTF(...)
 #endif
 
+static volatile int scheduled;
+static volatile rtimer_clock_t scheduled_time;
 /*---------------------------------------------------------------------------*/
 static void
 interrupt(int sig)
 {
   signal(sig, interrupt);
+  scheduled = 0;
   rtimer_run_next();
 }
 /*---------------------------------------------------------------------------*/
@@ -77,10 +80,20 @@ rtimer_arch_schedule(rtimer_clock_t t)
   struct itimerval val;
   rtimer_clock_t c;
 
-  c = t - (unsigned short)clock_time();
+  scheduled_time = t;
+  scheduled = 1;
+
+  c = t - (rtimer_clock_t)clock_time();
+  if(RTIMER_CLOCK_DIFF(t, (rtimer_clock_t)clock_time()) <= 0) {
+    c = 0;
+  }
   
   val.it_value.tv_sec = c / CLOCK_SECOND;
   val.it_value.tv_usec = (c % CLOCK_SECOND) * CLOCK_SECOND;
+  if(c == 0) {
+    /* A zero itimer would disarm the timer, fire as soon as possible */
+    val.it_value.tv_usec = 1;
+  }
 
   PRINTF("rtimer_arch_schedule time %u %u in %d.%d seconds\n", t, c, val.it_value.tv_sec,
       val.it_value.tv_usec);
@@ -90,3 +103,12 @@ rtimer_arch_schedule(rtimer_clock_t t)
 #endif /* !_WIN32 */
 }
 /*---------------------------------------------------------------------------*/
+int
+rtimer_arch_next_expiration(rtimer_clock_t *t)
+{
+  if(scheduled) {
+    *t = scheduled_time;
+  }
+  return scheduled;
+}
+/*---------------------------------------------------------------------------*/
@@ -46,4 +46,14 @@
 
 #define rtimer_arch_now() clock_time()
 
+/**
+ * \brief      Get the time of the pending real-time task, if any
+ * \param t    Set to the time the pending task is scheduled at
+ * \return     Non-zero if a task is pending, zero otherwise
+ *
+ *             Used by the platform main loop to not sleep past the
+ *             next real-time task.
+ */
+int rtimer_arch_next_expiration(rtimer_clock_t *t);
+
 #endif /* RTIMER_ARCH_H_ */
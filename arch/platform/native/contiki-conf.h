@@ -51,6 +51,18 @@ struct select_callback {
 };
 int select_set_callback(int fd, const struct select_callback *callback);
 
+/* Main loop statistics, kept when SELECT_CONF_STATS is set */
+struct select_stats {
+  unsigned long wakeups;        /* Total number of wake-ups */
+  unsigned long timeouts;       /* Wake-ups on select timeout */
+  unsigned long fd_wakeups;     /* Wake-ups on file descriptor activity */
+  unsigned long interrupts;     /* Wake-ups on signals */
+  unsigned long timer_wakeups;  /* Timeouts set for a timer deadline */
+  unsigned long lateness_total; /* Total timer lateness, in clock ticks */
+  unsigned long lateness_max;   /* Maximum timer lateness, in clock ticks */
+};
+const struct select_stats *select_get_stats(void);
+
 #define CC_CONF_REGISTER_ARGS          1
 #define CC_CONF_FUNCTION_POINTER_ARGS  1
 #define CC_CONF_VA_ARGS                1
@@ -93,6 +105,9 @@ typedef unsigned int uip_stats_t;
 
 #define UIP_CONF_IPV6_QUEUE_PKT  1
 #define UIP_ARCH_IPCHKSUM        1
+#ifndef UIP_CONF_CHKSUM_WIDE
+#define UIP_CONF_CHKSUM_WIDE     1
+#endif /* UIP_CONF_CHKSUM_WIDE */
 
 #endif /* NETSTACK_CONF_WITH_IPV6 */
 
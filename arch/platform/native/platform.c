@@ -80,12 +80,30 @@
  * @{
  */
 
+/*
+ * Uses epoll instead of select to wait for the monitored file
+ * descriptors (Linux only). Descriptors are registered once, in
+ * edge-triggered mode, and only the callbacks of descriptors that are
+ * ready are invoked.
+ */
+#ifdef SELECT_CONF_EPOLL
+#define SELECT_EPOLL SELECT_CONF_EPOLL
+#else
+#define SELECT_EPOLL 0
+#endif
+
+#if SELECT_EPOLL && !defined(__linux__)
+#error "SELECT_CONF_EPOLL is only supported on Linux"
+#endif
+
 /*
  * Defines the maximum number of file descriptors monitored by the platform
  * main loop.
  */
 #ifdef SELECT_CONF_MAX
 #define SELECT_MAX SELECT_CONF_MAX
+#elif SELECT_EPOLL
+#define SELECT_MAX FD_SETSIZE
 #else
 #define SELECT_MAX 8
 #endif
@@ -108,18 +126,258 @@
 #else
 #define SELECT_STDIN 1
 #endif
+
+/*
+ * Lets the main loop sleep until the next event timer or real-time task
+ * is due, instead of waking up every SELECT_TIMEOUT.
+ */
+#ifdef SELECT_CONF_TICKLESS
+#define SELECT_TICKLESS SELECT_CONF_TICKLESS
+#else
+#define SELECT_TICKLESS 1
+#endif
+
+/*
+ * Defines the maximum time (in msec) the main loop sleeps in tickless
+ * mode, when no timer is due earlier.
+ */
+#ifdef SELECT_CONF_MAX_SLEEP
+#define SELECT_MAX_SLEEP SELECT_CONF_MAX_SLEEP
+#else
+#define SELECT_MAX_SLEEP 1000
+#endif
+
+/*
+ * Keeps wake-up and timer lateness statistics of the main loop, and
+ * logs them every SELECT_STATS_PERIOD seconds.
+ */
+#ifdef SELECT_CONF_STATS
+#define SELECT_STATS SELECT_CONF_STATS
+#else
+#define SELECT_STATS 0
+#endif
+
+#ifdef SELECT_CONF_STATS_PERIOD
+#define SELECT_STATS_PERIOD SELECT_CONF_STATS_PERIOD
+#else
+#define SELECT_STATS_PERIOD 60
+#endif
 /** @} */
 /*---------------------------------------------------------------------------*/
+#if SELECT_EPOLL
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <poll.h>
+#endif /* SELECT_EPOLL */
 
 static const struct select_callback *select_callback[SELECT_MAX];
 static int select_max = 0;
 
+#if SELECT_EPOLL
+#define EPOLL_MAX_EVENTS 32
+
+/* Readiness flags of the monitored descriptors */
+#define FD_READABLE 0x01
+#define FD_WRITABLE 0x02
+#define FD_LISTED   0x04
+
+static int epoll_fd = -1;
+static uint8_t fd_flags[SELECT_MAX];
+/* Descriptors reported ready, until their readiness has been consumed */
+static int ready_fds[SELECT_MAX];
+static int ready_count;
+#endif /* SELECT_EPOLL */
+
+#if SELECT_TICKLESS
+/* Set when the main loop sleeps until a timer deadline */
+static int sleep_for_timer;
+static clock_time_t sleep_deadline;
+#endif /* SELECT_TICKLESS */
+
+#if SELECT_STATS
+static struct select_stats stats;
+static unsigned long stats_logged;
+#endif /* SELECT_STATS */
+
 #ifdef PLATFORM_CONF_MAC_ADDR
 static uint8_t mac_addr[] = PLATFORM_CONF_MAC_ADDR;
 #else /* PLATFORM_CONF_MAC_ADDR */
 static uint8_t mac_addr[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 };
 #endif /* PLATFORM_CONF_MAC_ADDR */
 
+/*---------------------------------------------------------------------------*/
+#if SELECT_EPOLL
+static void
+epoll_init(void)
+{
+  if(epoll_fd == -1) {
+    epoll_fd = epoll_create1(0);
+    if(epoll_fd == -1) {
+      perror("epoll_create1");
+      exit(1);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+ready_add(int fd, uint8_t flags)
+{
+  if(!(fd_flags[fd] & FD_LISTED)) {
+    ready_fds[ready_count++] = fd;
+  }
+  fd_flags[fd] |= flags | FD_LISTED;
+}
+/*---------------------------------------------------------------------------*/
+static void
+epoll_register(int fd, const struct select_callback *callback)
+{
+  struct epoll_event ev;
+
+  epoll_init();
+
+  if(callback == NULL) {
+    if(select_callback[fd] != NULL) {
+      /* Fails harmlessly if the descriptor was already closed */
+      epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+    }
+    /* Dropped from the ready list on the next dispatch */
+    fd_flags[fd] &= FD_LISTED;
+    return;
+  }
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+  ev.data.fd = fd;
+  if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+    if(errno == EPERM) {
+      /* Regular files do not support epoll, but are always ready,
+         just as select() reports them. */
+      ready_add(fd, FD_READABLE | FD_WRITABLE);
+    } else if(errno != EEXIST) {
+      perror("epoll_ctl");
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Calls the callbacks of the descriptors that are ready for what their
+   callback is waiting for. Returns non-zero if any of them is still
+   ready after its callback has run, i.e. if more work is pending. */
+static int
+epoll_dispatch(void)
+{
+  static struct pollfd handled[SELECT_MAX];
+  fd_set fdr;
+  fd_set fdw;
+  int want_read, want_write;
+  int nhandled;
+  int pending;
+  int fd;
+  int i;
+
+  nhandled = 0;
+  for(i = 0; i < ready_count;) {
+    fd = ready_fds[i];
+    if(select_callback[fd] == NULL ||
+       !(fd_flags[fd] & (FD_READABLE | FD_WRITABLE))) {
+      /* Nothing left to report, drop from the ready list */
+      fd_flags[fd] = 0;
+      ready_fds[i] = ready_fds[--ready_count];
+      continue;
+    }
+    i++;
+
+    /* Ask the callback what it waits for, as select() would */
+    FD_ZERO(&fdr);
+    FD_ZERO(&fdw);
+    if(!select_callback[fd]->set_fd(&fdr, &fdw)) {
+      continue;
+    }
+    want_read = FD_ISSET(fd, &fdr) && (fd_flags[fd] & FD_READABLE);
+    want_write = FD_ISSET(fd, &fdw) && (fd_flags[fd] & FD_WRITABLE);
+    if(!want_read && !want_write) {
+      continue;
+    }
+
+    FD_ZERO(&fdr);
+    FD_ZERO(&fdw);
+    if(want_read) {
+      FD_SET(fd, &fdr);
+    }
+    if(want_write) {
+      FD_SET(fd, &fdw);
+    }
+    select_callback[fd]->handle_fd(&fdr, &fdw);
+
+    handled[nhandled].fd = fd;
+    handled[nhandled].events = (want_read ? POLLIN : 0) |
+      (want_write ? POLLOUT : 0);
+    handled[nhandled].revents = 0;
+    nhandled++;
+  }
+
+  if(nhandled == 0) {
+    return 0;
+  }
+
+  /* With edge-triggered notifications, we have to find out whether the
+     callbacks consumed all of the readiness. Only the descriptors that
+     were just handled are checked. */
+  pending = 0;
+  if(poll(handled, nhandled, 0) < 0) {
+    return 0;
+  }
+  for(i = 0; i < nhandled; i++) {
+    fd = handled[i].fd;
+    if(handled[i].revents & POLLNVAL) {
+      fd_flags[fd] &= FD_LISTED;
+      continue;
+    }
+    if((handled[i].events & POLLIN) &&
+       !(handled[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+      fd_flags[fd] &= ~FD_READABLE;
+    }
+    if((handled[i].events & POLLOUT) &&
+       !(handled[i].revents & (POLLOUT | POLLERR))) {
+      fd_flags[fd] &= ~FD_WRITABLE;
+    }
+    if(handled[i].revents & handled[i].events) {
+      pending = 1;
+    }
+  }
+  return pending;
+}
+/*---------------------------------------------------------------------------*/
+static int
+epoll_wait_ready(const struct timeval *tv)
+{
+  static struct epoll_event events[EPOLL_MAX_EVENTS];
+  uint8_t flags;
+  int timeout;
+  int n;
+  int i;
+
+  epoll_init();
+
+  /* Timer deadlines are in whole milliseconds, shorter timeouts are
+     only used to poll the descriptors */
+  timeout = tv->tv_sec * 1000 + tv->tv_usec / 1000;
+  n = epoll_wait(epoll_fd, events, EPOLL_MAX_EVENTS, timeout);
+
+  for(i = 0; i < n; i++) {
+    flags = 0;
+    if(events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+      flags |= FD_READABLE;
+    }
+    if(events[i].events & (EPOLLOUT | EPOLLERR)) {
+      flags |= FD_WRITABLE;
+    }
+    if(select_callback[events[i].data.fd] != NULL) {
+      ready_add(events[i].data.fd, flags);
+    }
+  }
+  return n;
+}
+#endif /* SELECT_EPOLL */
 /*---------------------------------------------------------------------------*/
 int
 select_set_callback(int fd, const struct select_callback *callback)
@@ -132,6 +390,9 @@ select_set_callback(int fd, const struct select_callback *callback)
       callback = NULL;
     }
 
+#if SELECT_EPOLL
+    epoll_register(fd, callback);
+#endif /* SELECT_EPOLL */
     select_callback[fd] = callback;
 
     /* Update fd max */
@@ -153,6 +414,100 @@ select_set_callback(int fd, const struct select_callback *callback)
   return 0;
 }
 /*---------------------------------------------------------------------------*/
+const struct select_stats *
+select_get_stats(void)
+{
+#if SELECT_STATS
+  return &stats;
+#else /* SELECT_STATS */
+  return NULL;
+#endif /* SELECT_STATS */
+}
+/*---------------------------------------------------------------------------*/
+#if SELECT_STATS
+static void
+stats_update(int retval)
+{
+  clock_time_t late;
+
+  stats.wakeups++;
+  if(retval < 0) {
+    stats.interrupts++;
+  } else if(retval > 0) {
+    stats.fd_wakeups++;
+  } else {
+    stats.timeouts++;
+#if SELECT_TICKLESS
+    if(sleep_for_timer) {
+      late = clock_time() - sleep_deadline;
+      if((long)late < 0) {
+        late = 0;
+      }
+      stats.timer_wakeups++;
+      stats.lateness_total += late;
+      if(late > stats.lateness_max) {
+        stats.lateness_max = late;
+      }
+    }
+#endif /* SELECT_TICKLESS */
+  }
+
+  if(clock_seconds() - stats_logged >= SELECT_STATS_PERIOD) {
+    stats_logged = clock_seconds();
+    LOG_INFO("Main loop: %lu wake-ups (%lu timeouts, %lu fd, %lu signals)\n",
+             stats.wakeups, stats.timeouts, stats.fd_wakeups,
+             stats.interrupts);
+    LOG_INFO("Main loop: timer lateness avg %lu max %lu ticks over %lu\n",
+             stats.timer_wakeups > 0 ?
+             stats.lateness_total / stats.timer_wakeups : 0,
+             stats.lateness_max, stats.timer_wakeups);
+  }
+}
+#endif /* SELECT_STATS */
+/*---------------------------------------------------------------------------*/
+#if SELECT_TICKLESS
+/* Sets the select timeout to the time until the next event timer or
+   real-time task is due, at most SELECT_MAX_SLEEP */
+static void
+set_tickless_timeout(struct timeval *tv)
+{
+  clock_time_t now;
+  clock_time_t sleep;
+  clock_time_t next;
+  rtimer_clock_t rt;
+  int for_timer;
+
+  now = clock_time();
+  sleep = (clock_time_t)SELECT_MAX_SLEEP * CLOCK_SECOND / 1000;
+  for_timer = 0;
+
+  if(etimer_pending()) {
+    next = etimer_next_expiration_time() - now;
+    if((long)next < 0) {
+      next = 0;
+    }
+    if(next <= sleep) {
+      sleep = next;
+      for_timer = 1;
+    }
+  }
+
+  if(rtimer_arch_next_expiration(&rt)) {
+    next = RTIMER_CLOCK_DIFF(rt, (rtimer_clock_t)now) > 0 ?
+      RTIMER_CLOCK_DIFF(rt, (rtimer_clock_t)now) : 0;
+    if(next <= sleep) {
+      sleep = next;
+      for_timer = 1;
+    }
+  }
+
+  sleep_for_timer = for_timer;
+  sleep_deadline = now + sleep;
+  tv->tv_sec = sleep / CLOCK_SECOND;
+  tv->tv_usec = (sleep % CLOCK_SECOND) * (1000000 / CLOCK_SECOND);
+}
+#endif /* SELECT_TICKLESS */
+/*---------------------------------------------------------------------------*/
 #if SELECT_STDIN
 static int
 stdin_set_fd(fd_set *rset, fd_set *wset)
@@ -282,18 +637,48 @@ platform_main_loop()
   select_set_callback(STDIN_FILENO, &stdin_fd);
 #endif /* SELECT_STDIN */
   while(1) {
+#if !SELECT_EPOLL
     fd_set fdr;
     fd_set fdw;
     int maxfd;
     int i;
+#endif /* !SELECT_EPOLL */
     int retval;
     struct timeval tv;
 
-    retval = process_run();
+    retval = process_run_batch(PROCESS_RUN_BATCH);
+
+#if SELECT_EPOLL
+    /* Serve the descriptors already known to be ready */
+    retval |= epoll_dispatch();
+#endif /* SELECT_EPOLL */
 
+#if SELECT_TICKLESS
+    if(retval || process_nevents() > 0) {
+      tv.tv_sec = 0;
+      tv.tv_usec = 1;
+      sleep_for_timer = 0;
+    } else {
+      set_tickless_timeout(&tv);
+    }
+#else /* SELECT_TICKLESS */
     tv.tv_sec = 0;
     tv.tv_usec = retval ? 1 : SELECT_TIMEOUT;
+#endif /* SELECT_TICKLESS */
 
+#if SELECT_EPOLL
+    retval = epoll_wait_ready(&tv);
+#if SELECT_STATS
+    stats_update(retval);
+#endif /* SELECT_STATS */
+    if(retval < 0) {
+      if(errno != EINTR) {
+        perror("epoll_wait");
+      }
+    } else if(retval > 0) {
+      epoll_dispatch();
+    }
+#else /* SELECT_EPOLL */
     FD_ZERO(&fdr);
     FD_ZERO(&fdw);
     maxfd = 0;
@@ -304,6 +689,9 @@ platform_main_loop()
     }
 
     retval = select(maxfd + 1, &fdr, &fdw, NULL, &tv);
+#if SELECT_STATS
+    stats_update(retval);
+#endif /* SELECT_STATS */
     if(retval < 0) {
       if(errno != EINTR) {
         perror("select");
@@ -316,8 +704,17 @@ platform_main_loop()
         }
       }
     }
+#endif /* SELECT_EPOLL */
 
+#if SELECT_TICKLESS
+    /* Only poll the event timers once the next one is due */
+    if(etimer_pending() &&
+       (long)(clock_time() - etimer_next_expiration_time()) >= 0) {
+      etimer_request_poll();
+    }
+#else /* SELECT_TICKLESS */
     etimer_request_poll();
+#endif /* SELECT_TICKLESS */
   }
 
   return;
@@ -51,6 +51,11 @@ nested_function(void)
 {
   printf("stack usage: %u permitted: %u\n",
          stack_check_get_usage(), stack_check_get_reserved_size());
+#if STACK_CHECK_PER_PROCESS
+  /* Updated when the process returns */
+  printf("process peak stack usage so far: %u\n",
+         PROCESS_CURRENT()->stack_peak);
+#endif /* STACK_CHECK_PER_PROCESS */
 }
 /*---------------------------------------------------------------------------*/
 static void
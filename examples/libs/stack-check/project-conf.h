@@ -40,5 +40,6 @@
 #define PROJECT_CONF_H_
 
 #define STACK_CHECK_CONF_ENABLED 1
+#define STACK_CHECK_CONF_PER_PROCESS 1
 
 #endif /* PROJECT_CONF_H_ */
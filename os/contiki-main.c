@@ -53,6 +53,8 @@
 #include "services/orchestra/orchestra.h"
 #include "services/shell/serial-shell.h"
 #include "services/simple-energest/simple-energest.h"
+#include "services/process-profiler/process-profiler.h"
+#include "services/mem-stats/mem-stats.h"
 #include "services/tsch-cs/tsch-cs.h"
 
 #include <stdio.h>
@@ -112,6 +114,7 @@ main(void)
   {
     uip_ds6_addr_t *lladdr;
     memcpy(&uip_lladdr.addr, &linkaddr_node_addr, sizeof(uip_lladdr.addr));
+    process_set_priority(&tcpip_process, PROCESS_PRIORITY_HIGH);
     process_start(&tcpip_process, NULL);
 
     lladdr = uip_ds6_get_link_local(-1);
@@ -147,6 +150,14 @@ main(void)
   simple_energest_init();
 #endif /* BUILD_WITH_SIMPLE_ENERGEST */
 
+#if BUILD_WITH_PROCESS_PROFILER
+  process_profiler_init();
+#endif /* BUILD_WITH_PROCESS_PROFILER */
+
+#if BUILD_WITH_MEM_STATS
+  mem_stats_init();
+#endif /* BUILD_WITH_MEM_STATS */
+
 #if BUILD_WITH_TSCH_CS
   /* Initialize the channel selection module */
   tsch_cs_adaptations_init();
@@ -160,9 +171,9 @@ main(void)
   platform_main_loop();
 #else
   while(1) {
-    uint8_t r;
+    int r;
     do {
-      r = process_run();
+      r = process_run_batch(PROCESS_RUN_BATCH);
       watchdog_periodic();
     } while(r > 0);
 
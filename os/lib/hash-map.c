@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Intrusive hash map library implementation
+ */
+
+/**
+ * \addtogroup hash-map
+ * @{
+ */
+#include "lib/hash-map.h"
+
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#define LINK(map, item) (*(void **)((uint8_t *)(item) + (map)->link_offset))
+#define KEY(map, item) ((const uint8_t *)(item) + (map)->key_offset)
+/*---------------------------------------------------------------------------*/
+uint32_t
+hash_map_hash(const void *key, uint16_t len)
+{
+  const uint8_t *p = key;
+  uint32_t hash = 2166136261UL;
+
+  /* FNV-1a */
+  while(len-- > 0) {
+    hash = (hash ^ *p++) * 16777619UL;
+  }
+  return hash;
+}
+/*---------------------------------------------------------------------------*/
+/* Hash of the key, folded to a bucket index */
+static uint16_t
+bucket(hash_map_t map, const uint8_t *key)
+{
+  uint32_t hash = hash_map_hash(key, map->key_len);
+
+  return (hash ^ (hash >> 16)) & map->mask;
+}
+/*---------------------------------------------------------------------------*/
+void
+hash_map_init(hash_map_t map)
+{
+  memset(map->buckets, 0, (map->mask + 1) * sizeof(void *));
+  map->count = 0;
+}
+/*---------------------------------------------------------------------------*/
+bool
+hash_map_add(hash_map_t map, void *item)
+{
+  uint16_t b = bucket(map, KEY(map, item));
+  void *other;
+
+  for(other = map->buckets[b]; other != NULL; other = LINK(map, other)) {
+    if(memcmp(KEY(map, other), KEY(map, item), map->key_len) == 0) {
+      return false;
+    }
+  }
+  LINK(map, item) = map->buckets[b];
+  map->buckets[b] = item;
+  map->count++;
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+bool
+hash_map_remove(hash_map_t map, void *item)
+{
+  void **ptr = &map->buckets[bucket(map, KEY(map, item))];
+
+  for(; *ptr != NULL; ptr = &LINK(map, *ptr)) {
+    if(*ptr == item) {
+      *ptr = LINK(map, item);
+      map->count--;
+      return true;
+    }
+  }
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+void *
+hash_map_lookup(hash_map_t map, const void *key)
+{
+  void *item;
+
+  for(item = map->buckets[bucket(map, key)]; item != NULL;
+      item = LINK(map, item)) {
+    if(memcmp(KEY(map, item), key, map->key_len) == 0) {
+      return item;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Get the first item in the buckets from b on */
+static void *
+first_from(hash_map_t map, uint32_t b)
+{
+  for(; b <= map->mask; b++) {
+    if(map->buckets[b] != NULL) {
+      return map->buckets[b];
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+void *
+hash_map_head(hash_map_t map)
+{
+  return first_from(map, 0);
+}
+/*---------------------------------------------------------------------------*/
+void *
+hash_map_item_next(hash_map_t map, void *item)
+{
+  if(LINK(map, item) != NULL) {
+    return LINK(map, item);
+  }
+  return first_from(map, (uint32_t)bucket(map, KEY(map, item)) + 1);
+}
+/*---------------------------------------------------------------------------*/
+int
+hash_map_length(hash_map_t map)
+{
+  return map->count;
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Header file for the intrusive hash map library
+ */
+
+/** \addtogroup data
+ * @{ */
+
+/**
+ * \defgroup hash-map Intrusive hash map library
+ * @{
+ *
+ * The hash map library indexes items by a fixed-size key, in constant
+ * time on average. It needs no heap: the map is a static array of
+ * buckets, and items are typically allocated from a MEMB(). Items
+ * are chained in their bucket through a pointer that is part of the
+ * item, so an item can be in a hash map and in a list at the same
+ * time.
+ *
+ * Maps are declared with the HASH_MAP() macro, which names the item
+ * structure, the member used for chaining and the key member. Keys
+ * are compared byte by byte.
+ *
+ * \code
+ * struct route {
+ *   struct route *next;
+ *   void *hash_next;
+ *   uip_ipaddr_t addr;
+ * };
+ * HASH_MAP(routes_by_addr, 16, struct route, hash_next, addr);
+ * \endcode
+ */
+
+#ifndef HASH_MAP_H_
+#define HASH_MAP_H_
+
+#include "contiki.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define HASH_MAP_CONCAT2(s1, s2) s1##s2
+#define HASH_MAP_CONCAT(s1, s2) HASH_MAP_CONCAT2(s1, s2)
+
+/**
+ * \brief The state of a hash map. Only accessed through hash_map functions.
+ */
+struct hash_map {
+  void **buckets;
+  uint16_t mask;
+  uint16_t link_offset;
+  uint16_t key_offset;
+  uint16_t key_len;
+  uint16_t count;
+};
+
+/**
+ * The hash map type.
+ */
+typedef struct hash_map *hash_map_t;
+
+/**
+ * Declare a hash map.
+ *
+ * The map variable is declared as static to make it easy to use in a
+ * single C module without unnecessarily exporting the name to other
+ * modules. The map is empty.
+ *
+ * \param name The name of the map
+ * \param num_buckets The number of buckets, which must be a power of two
+ * \param type The type of the items, e.g. struct route
+ * \param link The member of type used to chain items, a void pointer
+ * \param key The key member of type
+ */
+#define HASH_MAP(name, num_buckets, type, link, key)                      \
+  static void *HASH_MAP_CONCAT(name,_buckets)[num_buckets];              \
+  static struct hash_map HASH_MAP_CONCAT(name,_hash_map) = {             \
+    HASH_MAP_CONCAT(name,_buckets), (num_buckets) - 1,                  \
+    offsetof(type, link), offsetof(type, key), sizeof(((type *)0)->key), \
+    0 };                                                                 \
+  static hash_map_t name = &HASH_MAP_CONCAT(name,_hash_map)
+
+/**
+ * \brief Hash a key, with the function that hash maps use
+ * \param key A pointer to the key
+ * \param len The length of the key, in bytes
+ * \return The 32-bit FNV-1a hash of the key
+ *
+ * For modules that keep an index of their own, e.g. one in which
+ * several items may have the same key.
+ */
+uint32_t hash_map_hash(const void *key, uint16_t len);
+
+/**
+ * \brief Remove all items from a hash map
+ * \param map The hash map
+ */
+void hash_map_init(hash_map_t map);
+
+/**
+ * \brief Add an item to a hash map
+ * \param map The hash map
+ * \param item The item, with its key set
+ * \return true if the item was added, false if an item with the same
+ *         key is already in the map
+ *
+ * The key of the item must not be changed while it is in the map.
+ */
+bool hash_map_add(hash_map_t map, void *item);
+
+/**
+ * \brief Remove an item from a hash map
+ * \param map The hash map
+ * \param item The item
+ * \return true if the item was removed, false if it was not in the map
+ */
+bool hash_map_remove(hash_map_t map, void *item);
+
+/**
+ * \brief Look up an item by key
+ * \param map The hash map
+ * \param key A pointer to the key, of the size of the key member
+ * \return The item with the key, or NULL if there is none
+ */
+void *hash_map_lookup(hash_map_t map, const void *key);
+
+/**
+ * \brief Get the first item of a hash map, in no particular order
+ * \param map The hash map
+ * \return The first item, or NULL if the map is empty
+ */
+void *hash_map_head(hash_map_t map);
+
+/**
+ * \brief Get the item that follows an item, in no particular order
+ * \param map The hash map
+ * \param item The item
+ * \return The next item, or NULL if item is the last one
+ *
+ * Together with hash_map_head(), visits every item once, as long as
+ * the map is not modified.
+ */
+void *hash_map_item_next(hash_map_t map, void *item);
+
+/**
+ * \brief Get the number of items in a hash map
+ * \param map The hash map
+ * \return The number of items
+ */
+int hash_map_length(hash_map_t map);
+
+#endif /* HASH_MAP_H_ */
+
+/** @} */
+/** @} */
@@ -57,6 +57,7 @@
 #include <string.h>
 
 #include "heapmem.h"
+#include "sys/cc.h"
 
 /* The HEAPMEM_CONF_ARENA_SIZE parameter determines the size of the
    space that will be statically allocated in this module. */
@@ -70,16 +71,17 @@
 /* HEAPMEM_CONF_ARENA_SIZE */
 
 /*
- * The HEAPMEM_CONF_SEARCH_MAX parameter limits the time spent on
- * chunk allocation and defragmentation. The lower this number is, the
- * faster the operations become. The cost of this speedup, however, is
- * that the space overhead might increase.
+ * The HEAPMEM_CONF_SMALL_BINS parameter sets the number of bins for
+ * small free chunks. Bin i holds the free chunks of exactly
+ * (i + 1) * HEAPMEM_ALIGNMENT bytes, so that small objects are
+ * allocated in constant time. Larger free chunks are kept in a
+ * best-fit tree. The parameter must be at least 4.
  */
-#ifdef HEAPMEM_CONF_SEARCH_MAX
-#define CHUNK_SEARCH_MAX HEAPMEM_CONF_SEARCH_MAX
+#ifdef HEAPMEM_CONF_SMALL_BINS
+#define SMALL_BINS HEAPMEM_CONF_SMALL_BINS
 #else
-#define CHUNK_SEARCH_MAX 16
-#endif /* HEAPMEM_CONF_SEARCH_MAX */
+#define SMALL_BINS 16
+#endif /* HEAPMEM_CONF_SMALL_BINS */
 
 /*
  * The HEAPMEM_CONF_REALLOC parameter determines whether heapmem_realloc() is
@@ -104,6 +106,14 @@
 #define ALIGN(size)						\
   (((size) + (HEAPMEM_ALIGNMENT - 1)) & ~(HEAPMEM_ALIGNMENT - 1))
 
+/* The largest chunk size that is kept in a small bin. */
+#define SMALL_MAX (SMALL_BINS * HEAPMEM_ALIGNMENT)
+#define SMALL_BIN(size) ((size) / HEAPMEM_ALIGNMENT - 1)
+
+/* A free chunk stores its size in its last bytes, so that it can be
+   found and coalesced when the chunk that follows it is freed. */
+#define MIN_CHUNK_SIZE ALIGN(sizeof(size_t))
+
 /* Macros for chunk iteration. */
 #define NEXT_CHUNK(chunk)						\
   ((chunk_t *)((char *)(chunk) + sizeof(chunk_t) + (chunk)->size))
@@ -119,6 +129,7 @@
 
 /* Macros for determining the status of a chunk. */
 #define CHUNK_FLAG_ALLOCATED		0x1
+#define CHUNK_FLAG_PREV_FREE		0x2
 
 #define CHUNK_ALLOCATED(chunk)			\
   ((chunk)->flags & CHUNK_FLAG_ALLOCATED)
@@ -126,9 +137,9 @@
   (~(chunk)->flags & CHUNK_FLAG_ALLOCATED)
 
 /*
- * We use a double-linked list of chunks, with a slight space overhead compared
- * to a single-linked list, but with the advantage of having much faster
- * list removals.
+ * We use a double-linked list of chunks in each small bin, with a
+ * slight space overhead compared to a single-linked list, but with
+ * the advantage of having much faster list removals.
  */
 typedef struct chunk {
   struct chunk *prev;
@@ -141,13 +152,35 @@ typedef struct chunk {
 #endif
 } chunk_t;
 
+/*
+ * Free chunks that are too large for the small bins are kept in a
+ * binary search tree, ordered by size and address. The tree links
+ * are stored in the otherwise unused memory of the free chunks.
+ */
+typedef struct tree_node {
+  chunk_t *left;
+  chunk_t *right;
+  chunk_t *parent;
+} tree_node_t;
+
+#define TREE_NODE(chunk) ((tree_node_t *)GET_PTR(chunk))
+
 /* All allocated space is located within an "heap", which is statically
    allocated with a pre-configured size. */
 static char heap_base[HEAPMEM_ARENA_SIZE];
 static size_t heap_usage;
 
 static chunk_t *first_chunk = (chunk_t *)heap_base;
-static chunk_t *free_list;
+static chunk_t *small_bins[SMALL_BINS];
+static chunk_t *free_tree;
+
+/* Allocation statistics, reported by heapmem_stats(). */
+static size_t allocations;
+static size_t alloc_failures;
+static size_t alloc_steps;
+static size_t alloc_steps_max;
+static size_t footprint_max;
+static void *failure_caller;
 
 /* extend_space: Increases the current footprint used in the heap, and
    returns a pointer to the old end. */
@@ -162,51 +195,178 @@ extend_space(size_t size)
 
   old_usage = &heap_base[heap_usage];
   heap_usage += size;
+  if(heap_usage > footprint_max) {
+    footprint_max = heap_usage;
+  }
 
   return old_usage;
 }
 
-/* free_chunk: Mark a chunk as being free, and put it on the free list. */
+/* tree_replace: Put a subtree in the place of a tree node. */
 static void
-free_chunk(chunk_t * const chunk)
+tree_replace(chunk_t *old, chunk_t *new)
 {
-  chunk->flags &= ~CHUNK_FLAG_ALLOCATED;
+  chunk_t *parent;
 
-  if(IS_LAST_CHUNK(chunk)) {
-    /* Release the chunk back into the wilderness. */
-    heap_usage -= sizeof(chunk_t) + chunk->size;
+  parent = TREE_NODE(old)->parent;
+  if(new != NULL) {
+    TREE_NODE(new)->parent = parent;
+  }
+  if(parent == NULL) {
+    free_tree = new;
+  } else if(TREE_NODE(parent)->left == old) {
+    TREE_NODE(parent)->left = new;
   } else {
-    /* Put the chunk on the free list. */
-    chunk->prev = NULL;
-    chunk->next = free_list;
-    if(free_list != NULL) {
-      free_list->prev = chunk;
-    }
-    free_list = chunk;
+    TREE_NODE(parent)->right = new;
   }
 }
 
-/* allocate_chunk: Mark a chunk as being allocated, and remove it
-   from the free list. */
+/* tree_insert: Put a large free chunk in the tree. */
 static void
-allocate_chunk(chunk_t * const chunk)
+tree_insert(chunk_t * const chunk)
 {
-  chunk->flags |= CHUNK_FLAG_ALLOCATED;
+  chunk_t *parent;
+  chunk_t **link;
+
+  parent = NULL;
+  link = &free_tree;
+  while(*link != NULL) {
+    parent = *link;
+    if(chunk->size < parent->size ||
+       (chunk->size == parent->size && chunk < parent)) {
+      link = &TREE_NODE(parent)->left;
+    } else {
+      link = &TREE_NODE(parent)->right;
+    }
+  }
+
+  TREE_NODE(chunk)->left = NULL;
+  TREE_NODE(chunk)->right = NULL;
+  TREE_NODE(chunk)->parent = parent;
+  *link = chunk;
+}
 
-  if(chunk == free_list) {
-    free_list = chunk->next;
-    if(free_list != NULL) {
-      free_list->prev = NULL;
+/* tree_remove: Take a large free chunk out of the tree. */
+static void
+tree_remove(chunk_t * const chunk)
+{
+  tree_node_t *node;
+  chunk_t *successor;
+
+  node = TREE_NODE(chunk);
+  if(node->left == NULL) {
+    tree_replace(chunk, node->right);
+  } else if(node->right == NULL) {
+    tree_replace(chunk, node->left);
+  } else {
+    /* Replace the chunk with the smallest chunk of its right subtree,
+       which has no left child. */
+    for(successor = node->right;
+        TREE_NODE(successor)->left != NULL;
+        successor = TREE_NODE(successor)->left);
+    tree_replace(successor, TREE_NODE(successor)->right);
+
+    TREE_NODE(successor)->left = node->left;
+    TREE_NODE(successor)->right = node->right;
+    TREE_NODE(node->left)->parent = successor;
+    if(node->right != NULL) {
+      TREE_NODE(node->right)->parent = successor;
     }
+    tree_replace(chunk, successor);
+  }
+}
+
+/* bin_insert: Put a free chunk in the small bin or the tree that
+   matches its size. */
+static void
+bin_insert(chunk_t * const chunk)
+{
+  chunk_t **bin;
+
+  if(chunk->size > SMALL_MAX) {
+    tree_insert(chunk);
+    return;
+  }
+
+  bin = &small_bins[SMALL_BIN(chunk->size)];
+  chunk->prev = NULL;
+  chunk->next = *bin;
+  if(*bin != NULL) {
+    (*bin)->prev = chunk;
+  }
+  *bin = chunk;
+}
+
+/* bin_remove: Take a free chunk out of its small bin or the tree. */
+static void
+bin_remove(chunk_t * const chunk)
+{
+  if(chunk->size > SMALL_MAX) {
+    tree_remove(chunk);
+    return;
+  }
+
+  if(chunk->prev == NULL) {
+    small_bins[SMALL_BIN(chunk->size)] = chunk->next;
   } else {
     chunk->prev->next = chunk->next;
   }
-
   if(chunk->next != NULL) {
     chunk->next->prev = chunk->prev;
   }
 }
 
+/* free_chunk: Mark a chunk as being free, coalesce it with its free
+   neighbors, and put it in a bin. */
+static void
+free_chunk(chunk_t *chunk)
+{
+  chunk_t *next;
+  size_t prev_size;
+
+  chunk->flags &= ~CHUNK_FLAG_ALLOCATED;
+
+  /* Coalesce with the next chunk. The last chunk is never free. */
+  if(!IS_LAST_CHUNK(chunk)) {
+    next = NEXT_CHUNK(chunk);
+    if(CHUNK_FREE(next)) {
+      bin_remove(next);
+      chunk->size += sizeof(chunk_t) + next->size;
+    }
+  }
+
+  /* Coalesce with the previous chunk, whose size is stored right
+     before this chunk. */
+  if(chunk->flags & CHUNK_FLAG_PREV_FREE) {
+    memcpy(&prev_size, (char *)chunk - sizeof(size_t), sizeof(size_t));
+    next = chunk;
+    chunk = (chunk_t *)((char *)chunk - prev_size - sizeof(chunk_t));
+    bin_remove(chunk);
+    chunk->size += sizeof(chunk_t) + next->size;
+  }
+
+  if(IS_LAST_CHUNK(chunk)) {
+    /* Release the chunk back into the wilderness. */
+    heap_usage -= sizeof(chunk_t) + chunk->size;
+    return;
+  }
+
+  bin_insert(chunk);
+  memcpy(GET_PTR(chunk) + chunk->size - sizeof(size_t),
+         &chunk->size, sizeof(size_t));
+  NEXT_CHUNK(chunk)->flags |= CHUNK_FLAG_PREV_FREE;
+}
+
+/* allocate_chunk: Mark a chunk as being allocated, and remove it
+   from its bin. */
+static void
+allocate_chunk(chunk_t * const chunk)
+{
+  bin_remove(chunk);
+  chunk->flags |= CHUNK_FLAG_ALLOCATED;
+  NEXT_CHUNK(chunk)->flags &= ~CHUNK_FLAG_PREV_FREE;
+}
+
 /*
  * split_chunk: When allocating a chunk, we may have found one that is
  * larger than needed, so this function is called to keep the rest of
@@ -219,80 +379,47 @@ split_chunk(chunk_t * const chunk, size_t offset)
 
   offset = ALIGN(offset);
 
-  if(offset + sizeof(chunk_t) < chunk->size) {
+  if(offset + sizeof(chunk_t) + MIN_CHUNK_SIZE <= chunk->size) {
     new_chunk = (chunk_t *)(GET_PTR(chunk) + offset);
     new_chunk->size = chunk->size - sizeof(chunk_t) - offset;
     new_chunk->flags = 0;
-    free_chunk(new_chunk);
-
     chunk->size = offset;
-    chunk->next = chunk->prev = NULL;
-  }
-}
-
-/* coalesce_chunks: Coalesce a specific free chunk with as many adjacent
-   free chunks as possible. */
-static void
-coalesce_chunks(chunk_t *chunk)
-{
-  chunk_t *next;
-
-  for(next = NEXT_CHUNK(chunk);
-      (char *)next < &heap_base[heap_usage] && CHUNK_FREE(next);
-      next = NEXT_CHUNK(next)) {
-    chunk->size += sizeof(chunk_t) + next->size;
-    allocate_chunk(next);
-  }
-}
-
-/* defrag_chunks: Scan the free list for chunks that can be coalesced,
-   and stop within a bounded time. */
-static void
-defrag_chunks(void)
-{
-  int i;
-  chunk_t *chunk;
-
-  /* Limit the time we spend on searching the free list. */
-  i = CHUNK_SEARCH_MAX;
-  for(chunk = free_list; chunk != NULL; chunk = chunk->next) {
-    if(i-- == 0) {
-      break;
-    }
-    coalesce_chunks(chunk);
+    free_chunk(new_chunk);
   }
 }
 
-/* get_free_chunk: Search the free list for the most suitable chunk, as
-   determined by its size, to satisfy an allocation request. */
+/* get_free_chunk: Find the most suitable free chunk, as determined by
+   its size, to satisfy an allocation request. */
 static chunk_t *
-get_free_chunk(const size_t size)
+get_free_chunk(const size_t size, size_t *steps)
 {
   int i;
   chunk_t *chunk, *best;
 
-  /* Defragment chunks only right before they are needed for allocation. */
-  defrag_chunks();
-
   best = NULL;
-  /* Limit the time we spend on searching the free list. */
-  i = CHUNK_SEARCH_MAX;
-  for(chunk = free_list; chunk != NULL; chunk = chunk->next) {
-    if(i-- == 0) {
-      break;
+  if(size <= SMALL_MAX) {
+    /* Take the first chunk of the smallest non-empty bin that fits. */
+    for(i = SMALL_BIN(size); i < SMALL_BINS; i++) {
+      (*steps)++;
+      if(small_bins[i] != NULL) {
+        best = small_bins[i];
+        break;
+      }
     }
+  }
 
+  if(best == NULL) {
     /*
      * To avoid fragmenting large chunks, we select the chunk with the
      * smallest size that is larger than or equal to the requested size.
      */
-    if(size <= chunk->size) {
-      if(best == NULL || chunk->size < best->size) {
+    for(chunk = free_tree; chunk != NULL;) {
+      (*steps)++;
+      if(size <= chunk->size) {
         best = chunk;
-      }
-      if(best->size == size) {
-        /* We found a perfect chunk -- stop the search. */
-        break;
+        chunk = TREE_NODE(chunk)->left;
+      } else {
+        chunk = TREE_NODE(chunk)->right;
       }
     }
   }
@@ -311,11 +438,11 @@ get_free_chunk(const size_t size)
  * a pointer to it in case of success, and NULL in case of failure.
  *
  * When allocating memory, heapmem_alloc() will first try to find a
- * free chunk of the same size and the requested one. If none can be
- * find, we pick a larger chunk that is as close in size as possible,
+ * free chunk of the same size and the requested one. Small chunks are
+ * found in constant time in the bin of their size. If none can be
+ * found, we pick a larger chunk that is as close in size as possible,
  * and possibly split it so that the remaining part becomes a chunk
- * available for allocation.  At most CHUNK_SEARCH_MAX chunks on the
- * free list will be examined.
+ * available for allocation.
  *
  * As a last resort, heapmem_alloc() will try to extend the heap
  * space, and thereby create a new chunk available for use.
@@ -328,20 +455,34 @@ heapmem_alloc(size_t size)
 #endif
 {
   chunk_t *chunk;
+  size_t steps;
 
   size = ALIGN(size);
+  if(size < MIN_CHUNK_SIZE) {
+    size = MIN_CHUNK_SIZE;
+  }
+
+  steps = 0;
+  chunk = get_free_chunk(size, &steps);
+
+  allocations++;
+  alloc_steps += steps;
+  if(steps > alloc_steps_max) {
+    alloc_steps_max = steps;
+  }
 
-  chunk = get_free_chunk(size);
   if(chunk == NULL) {
     chunk = extend_space(sizeof(chunk_t) + size);
     if(chunk == NULL) {
+      alloc_failures++;
+      failure_caller = CC_RETURN_ADDRESS();
       return NULL;
     }
     chunk->size = size;
+    /* The chunk before the wilderness is never free. */
+    chunk->flags = CHUNK_FLAG_ALLOCATED;
   }
 
-  chunk->flags = CHUNK_FLAG_ALLOCATED;
-
 #if HEAPMEM_DEBUG
   chunk->file = file;
   chunk->line = line;
@@ -359,10 +500,9 @@ heapmem_alloc(size_t size)
  * from heapmem_alloc or heapmem_realloc, without any call to
  * heapmem_free in between.
  *
- * When performing a deallocation of a chunk, the chunk will be put on
- * a list of free chunks internally. All free chunks that are adjacent
- * in memory will be merged into a single chunk in order to mitigate
- * fragmentation.
+ * When performing a deallocation of a chunk, the chunk is merged with
+ * the free chunks that are adjacent to it in memory, in order to
+ * mitigate fragmentation, and put in the bin of its size.
  */
 void
 #if HEAPMEM_DEBUG
@@ -410,7 +550,7 @@ heapmem_realloc(void *ptr, size_t size)
 {
   void *newptr;
   chunk_t *chunk;
-  int size_adj;
+  chunk_t *next;
 
   PRINTF("%s ptr %p size %u at %s:%u\n",
          __func__, ptr, (unsigned)size, file, line);
@@ -430,36 +570,38 @@ heapmem_realloc(void *ptr, size_t size)
 #endif
 
   size = ALIGN(size);
-  size_adj = size - chunk->size;
+  if(size < MIN_CHUNK_SIZE) {
+    size = MIN_CHUNK_SIZE;
+  }
 
-  if(size_adj <= 0) {
+  if(size <= chunk->size) {
     /* Request to make the object smaller or to keep its size.
        In the former case, the chunk will be split if possible. */
     split_chunk(chunk, size);
     return ptr;
   }
 
-  /* Request to make the object larger. (size_adj > 0) */
+  /* Request to make the object larger. */
   if(IS_LAST_CHUNK(chunk)) {
     /*
      * If the object is within the last allocated chunk (i.e., the
      * one before the end of the heap footprint, we just attempt to
      * extend the heap.
      */
-    if(extend_space(size_adj) != NULL) {
+    if(extend_space(size - chunk->size) != NULL) {
       chunk->size = size;
       return ptr;
     }
   } else {
     /*
-     * Here we attempt to enlarge an allocated object, whose
-     * adjacent space may already be allocated. We attempt to
-     * coalesce chunks in order to make as much room as possible.
+     * Here we attempt to enlarge an allocated object into the chunk
+     * that follows it, if that chunk is free and large enough. Free
+     * chunks are always coalesced, so there is at most one of them.
      */
-    coalesce_chunks(chunk);
-    if(chunk->size >= size) {
-      /* There was enough free adjacent space to extend the chunk in
-	 its current place. */
+    next = NEXT_CHUNK(chunk);
+    if(CHUNK_FREE(next) && chunk->size + sizeof(chunk_t) + next->size >= size) {
+      allocate_chunk(next);
+      chunk->size += sizeof(chunk_t) + next->size;
       split_chunk(chunk, size);
       return ptr;
     }
@@ -473,6 +615,8 @@ heapmem_realloc(void *ptr, size_t size)
    */
   newptr = heapmem_alloc(size);
   if(newptr == NULL) {
+    /* Blame the caller of heapmem_realloc() rather than ourselves. */
+    failure_caller = CC_RETURN_ADDRESS();
     return NULL;
   }
 
@@ -488,6 +632,8 @@ void
 heapmem_stats(heapmem_stats_t *stats)
 {
   chunk_t *chunk;
+  size_t wilderness;
+  size_t usable;
 
   memset(stats, 0, sizeof(*stats));
 
@@ -497,12 +643,50 @@ heapmem_stats(heapmem_stats_t *stats)
     if(CHUNK_ALLOCATED(chunk)) {
       stats->allocated += chunk->size;
     } else {
-      coalesce_chunks(chunk);
       stats->available += chunk->size;
+      if(chunk->size > stats->largest_free) {
+        stats->largest_free = chunk->size;
+      }
     }
     stats->overhead += sizeof(chunk_t);
   }
-  stats->available += HEAPMEM_ARENA_SIZE - heap_usage;
+
+  /* The wilderness can hold one more chunk. */
+  wilderness = HEAPMEM_ARENA_SIZE - heap_usage;
+  stats->available += wilderness;
+  usable = stats->available - wilderness;
+  if(wilderness > sizeof(chunk_t)) {
+    wilderness = (wilderness - sizeof(chunk_t)) & ~(HEAPMEM_ALIGNMENT - 1);
+    usable += wilderness;
+    if(wilderness > stats->largest_free) {
+      stats->largest_free = wilderness;
+    }
+  }
+
   stats->footprint = heap_usage;
   stats->chunks = stats->overhead / sizeof(chunk_t);
+  if(usable > 0) {
+    stats->fragmentation = 1000 -
+      (uint32_t)stats->largest_free * 1000 / (uint32_t)usable;
+  }
+
+  stats->allocations = allocations;
+  stats->alloc_failures = alloc_failures;
+  stats->alloc_steps = alloc_steps;
+  stats->alloc_steps_max = alloc_steps_max;
+  stats->footprint_max = footprint_max;
+  stats->failure_caller = failure_caller;
+}
+
+/* heapmem_stats_reset: Restart the statistics that accumulate over
+   time. */
+void
+heapmem_stats_reset(void)
+{
+  allocations = 0;
+  alloc_failures = 0;
+  alloc_steps = 0;
+  alloc_steps_max = 0;
+  footprint_max = heap_usage;
+  failure_caller = NULL;
 }
@@ -43,9 +43,11 @@
  * explicitly in order to be possible to use this module.
  *
  * Each allocated memory object is referred to as a "chunk". The
- * allocator manages free chunks in a double-linked list. While this
- * adds some memory overhead compared to a single-linked list, it
- * improves the performance of list management.
+ * allocator manages small free chunks in bins of equal-sized chunks,
+ * and larger free chunks in a tree ordered by size. Small objects are
+ * thereby allocated in constant time, and larger objects are
+ * allocated from the smallest free chunk that fits them. Free chunks
+ * are merged with their free neighbors as soon as they are freed.
  *
  * Internally, allocated chunks can be retrieved using the pointer to
  * the allocated memory returned by heapmem_alloc() and
@@ -82,6 +84,22 @@ typedef struct heapmem_stats {
   size_t available;
   size_t footprint;
   size_t chunks;
+  /* The size of the largest object that can currently be allocated */
+  size_t largest_free;
+  /* The share of free memory that is not part of the largest free
+     chunk, in permil */
+  size_t fragmentation;
+  /* The number of allocation requests, and of failed ones */
+  size_t allocations;
+  size_t alloc_failures;
+  /* The number of bins and tree nodes examined by all allocations,
+     and by the slowest one */
+  size_t alloc_steps;
+  size_t alloc_steps_max;
+  /* The peak footprint of the heap */
+  size_t footprint_max;
+  /* Where the last failed allocation was requested from, if known */
+  void *failure_caller;
 } heapmem_stats_t;
 
 #if HEAPMEM_DEBUG
@@ -154,13 +172,24 @@ void heapmem_free(void *ptr);
  * This function makes it possible to gain visibility into the internal
  * structure of the heap. One can thus obtain information regarding
  * the amount of memory allocated, overhead used for memory management,
- * and the number of chunks allocated. By using this information, developers
- * can tune their software to use the heapmem allocator more efficiently.
+ * and the number of chunks allocated. The fragmentation of the heap, the
+ * largest free block and the work spent on allocations are reported as
+ * well. By using this information, developers can tune their software to
+ * use the heapmem allocator more efficiently.
  *
  */
 
 void heapmem_stats(heapmem_stats_t *stats);
 
+/**
+ * \brief       Reset the heapmem statistics that accumulate over time.
+ *
+ * The allocation and failure counters, the allocation steps and the
+ * last failure caller are cleared, and the peak footprint restarts
+ * from the current footprint.
+ */
+void heapmem_stats_reset(void);
+
 #endif /* !HEAPMEM_H */
 
 /** @} */
@@ -47,12 +47,111 @@
 #include "contiki.h"
 #include "lib/memb.h"
 
+/*---------------------------------------------------------------------------*/
+#if MEMB_STATS
+static struct memb *registry;
+
+static void
+register_pool(struct memb *m)
+{
+  if(!m->registered) {
+    m->registered = 1;
+    m->registry_next = registry;
+    registry = m;
+  }
+}
+#define REGISTER(m) register_pool(m)
+#define RECORD_FAILURE(m) (m)->failure_caller = CC_RETURN_ADDRESS()
+#else /* MEMB_STATS */
+#define REGISTER(m)
+#define RECORD_FAILURE(m)
+#endif /* MEMB_STATS */
+/*---------------------------------------------------------------------------*/
+#if MEMB_WITH_FREE_LIST
+/* Marks an allocated block in the next[] array */
+#define MEMB_USED 0xffff
 /*---------------------------------------------------------------------------*/
 void
 memb_init(struct memb *m)
+{
+  memset(m->mem, 0, m->size * m->num);
+  m->free = 0;
+  m->untouched = 0;
+  m->used = 0;
+  m->used_max = 0;
+  m->failures = 0;
+  REGISTER(m);
+}
+/*---------------------------------------------------------------------------*/
+void *
+memb_alloc(struct memb *m)
+{
+  unsigned short i;
+
+  REGISTER(m);
+  if(m->free != 0) {
+    /* Pop the first block off the free list */
+    i = m->free - 1;
+    m->free = m->next[i];
+  } else if(m->untouched < m->num) {
+    /* Hand out a block that was never used before */
+    i = m->untouched++;
+  } else {
+    m->failures++;
+    RECORD_FAILURE(m);
+    return NULL;
+  }
+
+  m->next[i] = MEMB_USED;
+  if(++m->used > m->used_max) {
+    m->used_max = m->used;
+  }
+  return (void *)((char *)m->mem + (i * m->size));
+}
+/*---------------------------------------------------------------------------*/
+char
+memb_free(struct memb *m, void *ptr)
+{
+  unsigned long offset;
+  unsigned short i;
+
+  if(!memb_inmemb(m, ptr)) {
+    return -1;
+  }
+  offset = (char *)ptr - (char *)m->mem;
+  if(offset % m->size != 0) {
+    return -1;
+  }
+  i = offset / m->size;
+
+  if(i < m->untouched && m->next[i] == MEMB_USED) {
+    /* Push the block onto the free list. Blocks that are already free
+       are left alone, so that a double free is harmless. */
+    m->next[i] = m->free;
+    m->free = i + 1;
+    m->used--;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+memb_numfree(struct memb *m)
+{
+  return m->num - m->used;
+}
+/*---------------------------------------------------------------------------*/
+#else /* MEMB_WITH_FREE_LIST */
+void
+memb_init(struct memb *m)
 {
   memset(m->count, 0, m->num);
   memset(m->mem, 0, m->size * m->num);
+#if MEMB_STATS
+  m->used = 0;
+  m->used_max = 0;
+  m->failures = 0;
+  REGISTER(m);
+#endif /* MEMB_STATS */
 }
 /*---------------------------------------------------------------------------*/
 void *
@@ -60,18 +159,28 @@ memb_alloc(struct memb *m)
 {
   int i;
 
+  REGISTER(m);
   for(i = 0; i < m->num; ++i) {
     if(m->count[i] == 0) {
       /* If this block was unused, we increase the reference count to
 	 indicate that it now is used and return a pointer to the
 	 memory block. */
       ++(m->count[i]);
+#if MEMB_STATS
+      if(++m->used > m->used_max) {
+        m->used_max = m->used;
+      }
+#endif /* MEMB_STATS */
       return (void *)((char *)m->mem + (i * m->size));
     }
   }
 
   /* No free block was found, so we return NULL to indicate failure to
      allocate block. */
+#if MEMB_STATS
+  m->failures++;
+  RECORD_FAILURE(m);
+#endif /* MEMB_STATS */
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
@@ -92,6 +201,11 @@ memb_free(struct memb *m, void *ptr)
       if(m->count[i] > 0) {
 	/* Make sure that we don't deallocate free memory. */
 	--(m->count[i]);
+#if MEMB_STATS
+	if(m->count[i] == 0) {
+	  m->used--;
+	}
+#endif /* MEMB_STATS */
       }
       return m->count[i];
     }
@@ -101,13 +215,6 @@ memb_free(struct memb *m, void *ptr)
 }
 /*---------------------------------------------------------------------------*/
 int
-memb_inmemb(struct memb *m, void *ptr)
-{
-  return (char *)ptr >= (char *)m->mem &&
-    (char *)ptr < (char *)m->mem + (m->num * m->size);
-}
-/*---------------------------------------------------------------------------*/
-int
 memb_numfree(struct memb *m)
 {
   int i;
@@ -121,4 +228,40 @@ memb_numfree(struct memb *m)
 
   return num_free;
 }
+/*---------------------------------------------------------------------------*/
+#endif /* MEMB_WITH_FREE_LIST */
+/*---------------------------------------------------------------------------*/
+int
+memb_inmemb(struct memb *m, void *ptr)
+{
+  return (char *)ptr >= (char *)m->mem &&
+    (char *)ptr < (char *)m->mem + (m->num * m->size);
+}
+/*---------------------------------------------------------------------------*/
+#if MEMB_STATS
+struct memb *
+memb_registry_head(void)
+{
+  return registry;
+}
+/*---------------------------------------------------------------------------*/
+struct memb *
+memb_registry_next(struct memb *m)
+{
+  return m->registry_next;
+}
+/*---------------------------------------------------------------------------*/
+void
+memb_stats_reset(void)
+{
+  struct memb *m;
+
+  for(m = registry; m != NULL; m = m->registry_next) {
+    m->used_max = m->used;
+    m->failures = 0;
+    m->failure_caller = NULL;
+  }
+}
+#endif /* MEMB_STATS */
+/*---------------------------------------------------------------------------*/
 /** @} */
@@ -65,6 +65,44 @@
 
 #include "sys/cc.h"
 
+/**
+ * \brief Keep the free blocks of a pool on a free list
+ *
+ * By default, memb_alloc() and memb_free() walk the blocks of a pool
+ * to find a free one, or the one being freed. When
+ * MEMB_CONF_WITH_FREE_LIST is set, free blocks are kept on a list of
+ * block indices instead, so that both operations run in constant
+ * time. This costs one more byte of RAM per block. Each pool then
+ * also counts its peak number of used blocks (used_max) and its
+ * allocation failures (failures).
+ */
+#ifdef MEMB_CONF_WITH_FREE_LIST
+#define MEMB_WITH_FREE_LIST MEMB_CONF_WITH_FREE_LIST
+#else /* MEMB_CONF_WITH_FREE_LIST */
+#define MEMB_WITH_FREE_LIST 0
+#endif /* MEMB_CONF_WITH_FREE_LIST */
+
+/**
+ * \brief Keep allocation statistics for every pool
+ *
+ * When MEMB_CONF_STATS is set, every pool records its name, its peak
+ * number of used blocks, its allocation failures and the caller of
+ * the last failed allocation. Pools register themselves on a global
+ * list the first time they are initialized or allocated from, which
+ * can be walked with memb_registry_head() and memb_registry_next().
+ */
+#ifdef MEMB_CONF_STATS
+#define MEMB_STATS MEMB_CONF_STATS
+#else /* MEMB_CONF_STATS */
+#define MEMB_STATS 0
+#endif /* MEMB_CONF_STATS */
+
+#if MEMB_STATS
+#define MEMB_STATS_INIT(name) , .pool_name = #name
+#else /* MEMB_STATS */
+#define MEMB_STATS_INIT(name)
+#endif /* MEMB_STATS */
+
 /**
  * Declare a memory block.
  *
@@ -86,19 +124,65 @@ MEMB(connections, struct connection, 16);
  * \param num The total number of memory chunks in the block.
  *
  */
+#if MEMB_WITH_FREE_LIST
+#define MEMB(name, structure, num) \
+        static unsigned short CC_CONCAT(name,_memb_next)[num]; \
+        static structure CC_CONCAT(name,_memb_mem)[num]; \
+        static struct memb name = {sizeof(structure), num, \
+                                          CC_CONCAT(name,_memb_next), \
+                                          (void *)CC_CONCAT(name,_memb_mem) \
+                                          MEMB_STATS_INIT(name)}
+
+struct memb {
+  unsigned short size;
+  unsigned short num;
+  /* For every block: MEMB_USED if allocated, otherwise the free list
+     link, i.e. 1 + the index of the next free block or 0 */
+  unsigned short *next;
+  void *mem;
+  /* 1 + the index of the first block on the free list, or 0 */
+  unsigned short free;
+  /* The blocks from this index on were never allocated, so that a
+     pool is ready to use even before memb_init() is called */
+  unsigned short untouched;
+  unsigned short used;
+  /** The peak number of blocks in use */
+  unsigned short used_max;
+  /** The number of allocations that failed because the pool was full */
+  unsigned short failures;
+#if MEMB_STATS
+  const char *pool_name;
+  struct memb *registry_next;
+  /** Where the last failed allocation was requested from, if known */
+  void *failure_caller;
+  unsigned char registered;
+#endif /* MEMB_STATS */
+};
+#else /* MEMB_WITH_FREE_LIST */
 #define MEMB(name, structure, num) \
         static char CC_CONCAT(name,_memb_count)[num]; \
         static structure CC_CONCAT(name,_memb_mem)[num]; \
         static struct memb name = {sizeof(structure), num, \
                                           CC_CONCAT(name,_memb_count), \
-                                          (void *)CC_CONCAT(name,_memb_mem)}
+                                          (void *)CC_CONCAT(name,_memb_mem) \
+                                          MEMB_STATS_INIT(name)}
 
 struct memb {
   unsigned short size;
   unsigned short num;
   char *count;
   void *mem;
+#if MEMB_STATS
+  unsigned short used;
+  unsigned short used_max;
+  unsigned short failures;
+  const char *pool_name;
+  struct memb *registry_next;
+  void *failure_caller;
+  unsigned char registered;
+#endif /* MEMB_STATS */
 };
+#endif /* MEMB_WITH_FREE_LIST */
 
 /**
  * Initialize a memory block that was declared with MEMB().
@@ -132,6 +216,31 @@ int memb_inmemb(struct memb *m, void *ptr);
 
 int  memb_numfree(struct memb *m);
 
+#if MEMB_STATS
+/**
+ * Get the first pool on the registry of pools that have been
+ * initialized or allocated from.
+ *
+ * \return The first registered pool, or NULL if there is none.
+ */
+struct memb *memb_registry_head(void);
+
+/**
+ * Get the pool that follows a pool on the registry.
+ *
+ * \param m A registered pool.
+ *
+ * \return The next registered pool, or NULL if m is the last one.
+ */
+struct memb *memb_registry_next(struct memb *m);
+
+/**
+ * Restart the statistics of all registered pools: the peak usage is
+ * set to the current usage, and the failures are cleared.
+ */
+void memb_stats_reset(void);
+#endif /* MEMB_STATS */
+
 /** @} */
 /** @} */
 
@@ -0,0 +1,369 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Intrusive ordered map library implementation, as an AVL tree
+ */
+
+/**
+ * \addtogroup ordered-map
+ * @{
+ */
+#include "lib/ordered-map.h"
+
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#define NODE(map, item) \
+  ((struct ordered_map_node *)((uint8_t *)(item) + (map)->node_offset))
+#define ITEM(map, node) ((void *)((uint8_t *)(node) - (map)->node_offset))
+#define KEY(map, node) ((const uint8_t *)ITEM(map, node) + (map)->key_offset)
+/*---------------------------------------------------------------------------*/
+static int
+compare(ordered_map_t map, const void *key, struct ordered_map_node *n)
+{
+  if(map->cmp != NULL) {
+    return map->cmp(key, KEY(map, n));
+  }
+  return memcmp(key, KEY(map, n), map->key_len);
+}
+/*---------------------------------------------------------------------------*/
+/* Put node new in the place of node old, below parent */
+static void
+replace_child(ordered_map_t map, struct ordered_map_node *parent,
+              struct ordered_map_node *old, struct ordered_map_node *new)
+{
+  if(parent == NULL) {
+    map->root = new;
+  } else if(parent->left == old) {
+    parent->left = new;
+  } else {
+    parent->right = new;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+rotate_left(ordered_map_t map, struct ordered_map_node *n)
+{
+  struct ordered_map_node *r = n->right;
+
+  n->right = r->left;
+  if(r->left != NULL) {
+    r->left->parent = n;
+  }
+  r->parent = n->parent;
+  replace_child(map, n->parent, n, r);
+  r->left = n;
+  n->parent = r;
+}
+/*---------------------------------------------------------------------------*/
+static void
+rotate_right(ordered_map_t map, struct ordered_map_node *n)
+{
+  struct ordered_map_node *l = n->left;
+
+  n->left = l->right;
+  if(l->right != NULL) {
+    l->right->parent = n;
+  }
+  l->parent = n->parent;
+  replace_child(map, n->parent, n, l);
+  l->right = n;
+  n->parent = l;
+}
+/*---------------------------------------------------------------------------*/
+/* Rebalance the subtree rooted at n, whose balance is -2 or +2.
+   Returns the new root of the subtree, whose balance is 0 if the
+   height of the subtree decreased. */
+static struct ordered_map_node *
+rebalance(ordered_map_t map, struct ordered_map_node *n)
+{
+  struct ordered_map_node *c, *g;
+
+  if(n->balance > 0) {
+    c = n->right;
+    if(c->balance >= 0) {
+      rotate_left(map, n);
+      if(c->balance == 0) {
+        n->balance = 1;
+        c->balance = -1;
+      } else {
+        n->balance = 0;
+        c->balance = 0;
+      }
+      return c;
+    }
+    g = c->left;
+    rotate_right(map, c);
+    rotate_left(map, n);
+    n->balance = g->balance > 0 ? -1 : 0;
+    c->balance = g->balance < 0 ? 1 : 0;
+  } else {
+    c = n->left;
+    if(c->balance <= 0) {
+      rotate_right(map, n);
+      if(c->balance == 0) {
+        n->balance = -1;
+        c->balance = 1;
+      } else {
+        n->balance = 0;
+        c->balance = 0;
+      }
+      return c;
+    }
+    g = c->right;
+    rotate_left(map, c);
+    rotate_right(map, n);
+    n->balance = g->balance < 0 ? 1 : 0;
+    c->balance = g->balance > 0 ? -1 : 0;
+  }
+  g->balance = 0;
+  return g;
+}
+/*---------------------------------------------------------------------------*/
+void
+ordered_map_init(ordered_map_t map)
+{
+  map->root = NULL;
+  map->count = 0;
+}
+/*---------------------------------------------------------------------------*/
+bool
+ordered_map_add(ordered_map_t map, void *item)
+{
+  struct ordered_map_node *n = NODE(map, item);
+  struct ordered_map_node *p = NULL;
+  struct ordered_map_node **link = &map->root;
+  const void *key = KEY(map, n);
+  int c;
+
+  while(*link != NULL) {
+    p = *link;
+    c = compare(map, key, p);
+    if(c == 0) {
+      return false;
+    }
+    link = c < 0 ? &p->left : &p->right;
+  }
+  n->left = n->right = NULL;
+  n->parent = p;
+  n->balance = 0;
+  *link = n;
+  map->count++;
+
+  /* Update the balance of the ancestors, until the height of a
+     subtree does not change */
+  for(; p != NULL; n = p, p = p->parent) {
+    p->balance += n == p->left ? -1 : 1;
+    if(p->balance == 0) {
+      break;
+    }
+    if(p->balance == 2 || p->balance == -2) {
+      rebalance(map, p);
+      break;
+    }
+  }
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+void
+ordered_map_remove(ordered_map_t map, void *item)
+{
+  struct ordered_map_node *n = NODE(map, item);
+  struct ordered_map_node *p, *s, *c, *g;
+  bool left;
+
+  if(n->left != NULL && n->right != NULL) {
+    /* Put the successor of n in its place */
+    s = n->right;
+    while(s->left != NULL) {
+      s = s->left;
+    }
+    if(s->parent == n) {
+      p = s;
+      left = false;
+    } else {
+      p = s->parent;
+      left = true;
+      p->left = s->right;
+      if(s->right != NULL) {
+        s->right->parent = p;
+      }
+      s->right = n->right;
+      n->right->parent = s;
+    }
+    s->left = n->left;
+    n->left->parent = s;
+    s->parent = n->parent;
+    s->balance = n->balance;
+    replace_child(map, n->parent, n, s);
+  } else {
+    c = n->left != NULL ? n->left : n->right;
+    p = n->parent;
+    left = p != NULL && p->left == n;
+    if(c != NULL) {
+      c->parent = p;
+    }
+    replace_child(map, p, n, c);
+  }
+  map->count--;
+
+  /* Update the balance of the ancestors, while the height of their
+     subtree decreases */
+  while(p != NULL) {
+    g = p->parent;
+    p->balance += left ? 1 : -1;
+    if(p->balance == 1 || p->balance == -1) {
+      break;
+    }
+    if(p->balance != 0) {
+      p = rebalance(map, p);
+      if(p->balance != 0) {
+        break;
+      }
+    }
+    left = g != NULL && g->left == p;
+    p = g;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void *
+ordered_map_lookup(ordered_map_t map, const void *key)
+{
+  struct ordered_map_node *n = map->root;
+  int c;
+
+  while(n != NULL) {
+    c = compare(map, key, n);
+    if(c == 0) {
+      return ITEM(map, n);
+    }
+    n = c < 0 ? n->left : n->right;
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+void *
+ordered_map_lower_bound(ordered_map_t map, const void *key)
+{
+  struct ordered_map_node *n = map->root;
+  struct ordered_map_node *found = NULL;
+  int c;
+
+  while(n != NULL) {
+    c = compare(map, key, n);
+    if(c == 0) {
+      return ITEM(map, n);
+    }
+    if(c < 0) {
+      found = n;
+      n = n->left;
+    } else {
+      n = n->right;
+    }
+  }
+  return found != NULL ? ITEM(map, found) : NULL;
+}
+/*---------------------------------------------------------------------------*/
+void *
+ordered_map_head(ordered_map_t map)
+{
+  struct ordered_map_node *n = map->root;
+
+  if(n == NULL) {
+    return NULL;
+  }
+  while(n->left != NULL) {
+    n = n->left;
+  }
+  return ITEM(map, n);
+}
+/*---------------------------------------------------------------------------*/
+void *
+ordered_map_tail(ordered_map_t map)
+{
+  struct ordered_map_node *n = map->root;
+
+  if(n == NULL) {
+    return NULL;
+  }
+  while(n->right != NULL) {
+    n = n->right;
+  }
+  return ITEM(map, n);
+}
+/*---------------------------------------------------------------------------*/
+void *
+ordered_map_item_next(ordered_map_t map, void *item)
+{
+  struct ordered_map_node *n = NODE(map, item);
+
+  if(n->right != NULL) {
+    n = n->right;
+    while(n->left != NULL) {
+      n = n->left;
+    }
+    return ITEM(map, n);
+  }
+  while(n->parent != NULL && n == n->parent->right) {
+    n = n->parent;
+  }
+  return n->parent != NULL ? ITEM(map, n->parent) : NULL;
+}
+/*---------------------------------------------------------------------------*/
+void *
+ordered_map_item_prev(ordered_map_t map, void *item)
+{
+  struct ordered_map_node *n = NODE(map, item);
+
+  if(n->left != NULL) {
+    n = n->left;
+    while(n->right != NULL) {
+      n = n->right;
+    }
+    return ITEM(map, n);
+  }
+  while(n->parent != NULL && n == n->parent->left) {
+    n = n->parent;
+  }
+  return n->parent != NULL ? ITEM(map, n->parent) : NULL;
+}
+/*---------------------------------------------------------------------------*/
+int
+ordered_map_length(ordered_map_t map)
+{
+  return map->count;
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
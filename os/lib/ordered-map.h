@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Header file for the intrusive ordered map library
+ */
+
+/** \addtogroup data
+ * @{ */
+
+/**
+ * \defgroup ordered-map Intrusive ordered map library
+ * @{
+ *
+ * The ordered map library keeps items sorted by a fixed-size key in
+ * an AVL tree: lookups, insertions and removals take O(log n) steps,
+ * and items can be visited in key order, or from the first key
+ * greater than or equal to a given one. It needs no heap: the tree
+ * nodes are part of the items, which are typically allocated from a
+ * MEMB(). An item can be in an ordered map and in a list at the same
+ * time.
+ *
+ * Maps are declared with the ORDERED_MAP() macro, which names the
+ * item structure, its node member, its key member, and the function
+ * that compares keys. Without a function, keys are compared with
+ * memcmp(), which sorts big-endian numbers and addresses in order.
+ *
+ * \code
+ * struct entry {
+ *   struct entry *next;
+ *   struct ordered_map_node node;
+ *   uint16_t key;
+ * };
+ * ORDERED_MAP(entries, struct entry, node, key, compare_uint16);
+ * \endcode
+ */
+
+#ifndef ORDERED_MAP_H_
+#define ORDERED_MAP_H_
+
+#include "contiki.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ORDERED_MAP_CONCAT2(s1, s2) s1##s2
+#define ORDERED_MAP_CONCAT(s1, s2) ORDERED_MAP_CONCAT2(s1, s2)
+
+/**
+ * \brief A tree node, to be included in the items of an ordered map
+ */
+struct ordered_map_node {
+  struct ordered_map_node *left;
+  struct ordered_map_node *right;
+  struct ordered_map_node *parent;
+  /* The height of the right subtree minus that of the left one */
+  int8_t balance;
+};
+
+/**
+ * \brief A key comparison function
+ * \return A negative value, zero or a positive value if the first key
+ *         is respectively lower than, equal to or greater than the second
+ */
+typedef int (*ordered_map_cmp_t)(const void *key1, const void *key2);
+
+/**
+ * \brief The state of an ordered map. Only accessed through
+ *        ordered_map functions.
+ */
+struct ordered_map {
+  struct ordered_map_node *root;
+  ordered_map_cmp_t cmp;
+  uint16_t node_offset;
+  uint16_t key_offset;
+  uint16_t key_len;
+  uint16_t count;
+};
+
+/**
+ * The ordered map type.
+ */
+typedef struct ordered_map *ordered_map_t;
+
+/**
+ * Declare an ordered map.
+ *
+ * The map variable is declared as static to make it easy to use in a
+ * single C module without unnecessarily exporting the name to other
+ * modules. The map is empty.
+ *
+ * \param name The name of the map
+ * \param type The type of the items, e.g. struct entry
+ * \param node The struct ordered_map_node member of type
+ * \param key The key member of type
+ * \param cmp The key comparison function, or NULL to use memcmp()
+ */
+#define ORDERED_MAP(name, type, node, key, cmp)                            \
+  static struct ordered_map ORDERED_MAP_CONCAT(name,_ordered_map) = {     \
+    NULL, cmp, offsetof(type, node), offsetof(type, key),                 \
+    sizeof(((type *)0)->key), 0 };                                        \
+  static ordered_map_t name = &ORDERED_MAP_CONCAT(name,_ordered_map)
+
+/**
+ * \brief Remove all items from an ordered map
+ * \param map The ordered map
+ */
+void ordered_map_init(ordered_map_t map);
+
+/**
+ * \brief Add an item to an ordered map
+ * \param map The ordered map
+ * \param item The item, with its key set
+ * \return true if the item was added, false if an item with the same
+ *         key is already in the map
+ *
+ * The key of the item must not be changed while it is in the map.
+ */
+bool ordered_map_add(ordered_map_t map, void *item);
+
+/**
+ * \brief Remove an item from an ordered map
+ * \param map The ordered map
+ * \param item The item, which must be in the map
+ */
+void ordered_map_remove(ordered_map_t map, void *item);
+
+/**
+ * \brief Look up an item by key
+ * \param map The ordered map
+ * \param key A pointer to the key
+ * \return The item with the key, or NULL if there is none
+ */
+void *ordered_map_lookup(ordered_map_t map, const void *key);
+
+/**
+ * \brief Look up the first item with a key greater than or equal to a key
+ * \param map The ordered map
+ * \param key A pointer to the key
+ * \return The item, or NULL if all keys are lower than key
+ */
+void *ordered_map_lower_bound(ordered_map_t map, const void *key);
+
+/**
+ * \brief Get the item with the lowest key
+ * \param map The ordered map
+ * \return The item, or NULL if the map is empty
+ */
+void *ordered_map_head(ordered_map_t map);
+
+/**
+ * \brief Get the item with the highest key
+ * \param map The ordered map
+ * \return The item, or NULL if the map is empty
+ */
+void *ordered_map_tail(ordered_map_t map);
+
+/**
+ * \brief Get the item with the next key
+ * \param map The ordered map
+ * \param item The item
+ * \return The next item, or NULL if item has the highest key
+ */
+void *ordered_map_item_next(ordered_map_t map, void *item);
+
+/**
+ * \brief Get the item with the previous key
+ * \param map The ordered map
+ * \param item The item
+ * \return The previous item, or NULL if item has the lowest key
+ */
+void *ordered_map_item_prev(ordered_map_t map, void *item);
+
+/**
+ * \brief Get the number of items in an ordered map
+ * \param map The ordered map
+ * \return The number of items
+ */
+int ordered_map_length(ordered_map_t map);
+
+#endif /* ORDERED_MAP_H_ */
+
+/** @} */
+/** @} */
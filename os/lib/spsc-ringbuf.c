@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Single-producer, single-consumer ring buffer library
+ */
+
+#include "lib/spsc-ringbuf.h"
+#include "sys/memory-barrier.h"
+#include "sys/cc.h"
+
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+/* Copy len bytes to the buffer, at pointer ptr, wrapping around */
+static void
+copy_in(struct spsc_ringbuf *r, spsc_ringbuf_ptr_t ptr,
+        const uint8_t *data, int len)
+{
+  int offset = ptr & r->mask;
+  int first = MIN(len, (int)r->mask + 1 - offset);
+
+  memcpy(r->data + offset, data, first);
+  memcpy(r->data, data + first, len - first);
+}
+/*---------------------------------------------------------------------------*/
+/* Copy len bytes from the buffer, at pointer ptr, wrapping around */
+static void
+copy_out(const struct spsc_ringbuf *r, spsc_ringbuf_ptr_t ptr,
+         uint8_t *data, int len)
+{
+  int offset = ptr & r->mask;
+  int first = MIN(len, (int)r->mask + 1 - offset);
+
+  memcpy(data, r->data + offset, first);
+  memcpy(data + first, r->data, len - first);
+}
+/*---------------------------------------------------------------------------*/
+/* Get the free space, as seen by the producer */
+static int
+free_space(struct spsc_ringbuf *r, spsc_ringbuf_ptr_t put_ptr)
+{
+  spsc_ringbuf_ptr_t get_ptr = r->get_ptr;
+
+  /* The consumer must be done reading before we overwrite its data */
+  memory_barrier();
+  return (int)r->mask + 1 - (spsc_ringbuf_ptr_t)(put_ptr - get_ptr);
+}
+/*---------------------------------------------------------------------------*/
+/* Get the number of bytes available, as seen by the consumer */
+static int
+available(const struct spsc_ringbuf *r, spsc_ringbuf_ptr_t get_ptr)
+{
+  spsc_ringbuf_ptr_t put_ptr = r->put_ptr;
+
+  /* The data must not be read before the pointer that publishes it */
+  memory_barrier();
+  return (spsc_ringbuf_ptr_t)(put_ptr - get_ptr);
+}
+/*---------------------------------------------------------------------------*/
+/* Publish data to the consumer */
+static void
+commit_put(struct spsc_ringbuf *r, spsc_ringbuf_ptr_t put_ptr)
+{
+  memory_barrier();
+  r->put_ptr = put_ptr;
+}
+/*---------------------------------------------------------------------------*/
+/* Release space to the producer */
+static void
+commit_get(struct spsc_ringbuf *r, spsc_ringbuf_ptr_t get_ptr)
+{
+  memory_barrier();
+  r->get_ptr = get_ptr;
+}
+/*---------------------------------------------------------------------------*/
+void
+spsc_ringbuf_init(struct spsc_ringbuf *r, uint8_t *a, spsc_ringbuf_ptr_t size)
+{
+  r->data = a;
+  r->mask = size - 1;
+  r->put_ptr = 0;
+  r->get_ptr = 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+spsc_ringbuf_put(struct spsc_ringbuf *r, const void *data, int len)
+{
+  spsc_ringbuf_ptr_t put_ptr = r->put_ptr;
+
+  len = MIN(len, free_space(r, put_ptr));
+  if(len > 0) {
+    copy_in(r, put_ptr, data, len);
+    commit_put(r, put_ptr + len);
+  }
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+int
+spsc_ringbuf_get(struct spsc_ringbuf *r, void *data, int len)
+{
+  spsc_ringbuf_ptr_t get_ptr = r->get_ptr;
+
+  len = MIN(len, available(r, get_ptr));
+  if(len > 0) {
+    copy_out(r, get_ptr, data, len);
+    commit_get(r, get_ptr + len);
+  }
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+int
+spsc_ringbuf_put_record(struct spsc_ringbuf *r, const void *data, uint16_t len)
+{
+  spsc_ringbuf_ptr_t put_ptr = r->put_ptr;
+  uint8_t hdr[SPSC_RINGBUF_RECORD_HDR_LEN];
+
+  if(SPSC_RINGBUF_RECORD_HDR_LEN + len > free_space(r, put_ptr)) {
+    return 0;
+  }
+  hdr[0] = len & 0xff;
+  hdr[1] = len >> 8;
+  copy_in(r, put_ptr, hdr, sizeof(hdr));
+  copy_in(r, put_ptr + sizeof(hdr), data, len);
+  commit_put(r, put_ptr + sizeof(hdr) + len);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+spsc_ringbuf_get_record(struct spsc_ringbuf *r, void *data, uint16_t maxlen)
+{
+  spsc_ringbuf_ptr_t get_ptr = r->get_ptr;
+  uint8_t hdr[SPSC_RINGBUF_RECORD_HDR_LEN];
+  uint16_t len;
+
+  /* Records are published whole, so the header is enough to tell */
+  if(available(r, get_ptr) < SPSC_RINGBUF_RECORD_HDR_LEN) {
+    return -1;
+  }
+  copy_out(r, get_ptr, hdr, sizeof(hdr));
+  len = hdr[0] | (hdr[1] << 8);
+  copy_out(r, get_ptr + sizeof(hdr), data, MIN(len, maxlen));
+  commit_get(r, get_ptr + sizeof(hdr) + len);
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+int
+spsc_ringbuf_peek_record(const struct spsc_ringbuf *r)
+{
+  spsc_ringbuf_ptr_t get_ptr = r->get_ptr;
+  uint8_t hdr[SPSC_RINGBUF_RECORD_HDR_LEN];
+
+  if(available(r, get_ptr) < SPSC_RINGBUF_RECORD_HDR_LEN) {
+    return -1;
+  }
+  copy_out(r, get_ptr, hdr, sizeof(hdr));
+  return hdr[0] | (hdr[1] << 8);
+}
+/*---------------------------------------------------------------------------*/
+int
+spsc_ringbuf_size(const struct spsc_ringbuf *r)
+{
+  return (int)r->mask + 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+spsc_ringbuf_elements(const struct spsc_ringbuf *r)
+{
+  return (spsc_ringbuf_ptr_t)(r->put_ptr - r->get_ptr);
+}
+/*---------------------------------------------------------------------------*/
+int
+spsc_ringbuf_free(const struct spsc_ringbuf *r)
+{
+  return spsc_ringbuf_size(r) - spsc_ringbuf_elements(r);
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Header file for the single-producer, single-consumer ring
+ *         buffer library
+ */
+
+/** \addtogroup data
+ * @{ */
+
+/**
+ * \defgroup spsc-ringbuf Single-producer, single-consumer ring buffer
+ * @{
+ *
+ * A lock-free ring buffer of bytes, for handing data from one
+ * producer to one consumer, typically from an interrupt handler to a
+ * process. Unlike the \ref ringbuf "ring buffer library", data is
+ * put and got in bulk, the buffer can be larger than 128 bytes, and
+ * variable-length records (e.g. whole frames) can be stored.
+ *
+ * Each put pointer is only written by the producer, and each get
+ * pointer only by the consumer, so that no lock is needed as long as
+ * there is a single producer and a single consumer. Data is made
+ * visible to the other side with memory_barrier() before the pointer
+ * is updated.
+ *
+ * Bytes and records must not be mixed in the same buffer.
+ */
+
+#ifndef SPSC_RINGBUF_H_
+#define SPSC_RINGBUF_H_
+
+#include "contiki.h"
+
+/**
+ * \brief The type of the put and get pointers
+ *
+ * The pointers must be read and written atomically, which limits
+ * their width on 8-bit and 16-bit CPUs. By default, they are 16-bit
+ * wide and the buffer size is limited to 32768 bytes. Set
+ * SPSC_RINGBUF_CONF_32BIT to use 32-bit pointers and larger buffers.
+ */
+#ifdef SPSC_RINGBUF_CONF_32BIT
+#define SPSC_RINGBUF_32BIT SPSC_RINGBUF_CONF_32BIT
+#else /* SPSC_RINGBUF_CONF_32BIT */
+#define SPSC_RINGBUF_32BIT 0
+#endif /* SPSC_RINGBUF_CONF_32BIT */
+
+#if SPSC_RINGBUF_32BIT
+typedef uint32_t spsc_ringbuf_ptr_t;
+#else /* SPSC_RINGBUF_32BIT */
+typedef uint16_t spsc_ringbuf_ptr_t;
+#endif /* SPSC_RINGBUF_32BIT */
+
+/** The size of the header stored in front of each record */
+#define SPSC_RINGBUF_RECORD_HDR_LEN 2
+
+/**
+ * \brief Structure that holds the state of a ring buffer.
+ *
+ * The pointers count the bytes ever put and got, and wrap around
+ * with the width of their type. The actual buffer needs to be
+ * defined separately.
+ */
+struct spsc_ringbuf {
+  uint8_t *data;
+  spsc_ringbuf_ptr_t mask;
+  /* Only written by the producer */
+  volatile spsc_ringbuf_ptr_t put_ptr;
+  /* Only written by the consumer */
+  volatile spsc_ringbuf_ptr_t get_ptr;
+};
+
+/**
+ * \brief Initialize a ring buffer
+ * \param r Pointer to the ring buffer
+ * \param a Pointer to an array to hold the data in the buffer
+ * \param size The size of the array, which must be a power of two,
+ *             and at most half the range of spsc_ringbuf_ptr_t
+ */
+void spsc_ringbuf_init(struct spsc_ringbuf *r, uint8_t *a,
+                       spsc_ringbuf_ptr_t size);
+
+/**
+ * \brief Put bytes into the ring buffer. Called by the producer only.
+ * \param r Pointer to the ring buffer
+ * \param data The bytes to put
+ * \param len The number of bytes to put
+ * \return The number of bytes put, which is less than len if the
+ *         buffer is full
+ */
+int spsc_ringbuf_put(struct spsc_ringbuf *r, const void *data, int len);
+
+/**
+ * \brief Get bytes from the ring buffer. Called by the consumer only.
+ * \param r Pointer to the ring buffer
+ * \param data The buffer to copy the bytes to
+ * \param len The maximum number of bytes to get
+ * \return The number of bytes got, which is less than len if the
+ *         buffer is empty
+ */
+int spsc_ringbuf_get(struct spsc_ringbuf *r, void *data, int len);
+
+/**
+ * \brief Put a record into the ring buffer. Called by the producer only.
+ * \param r Pointer to the ring buffer
+ * \param data The record
+ * \param len The length of the record
+ * \return 1 if the record was put, 0 if there was not enough space
+ *
+ *         The record takes len + SPSC_RINGBUF_RECORD_HDR_LEN bytes
+ *         in the buffer. It is either put whole, or not at all.
+ */
+int spsc_ringbuf_put_record(struct spsc_ringbuf *r,
+                            const void *data, uint16_t len);
+
+/**
+ * \brief Get a record from the ring buffer. Called by the consumer only.
+ * \param r Pointer to the ring buffer
+ * \param data The buffer to copy the record to
+ * \param maxlen The size of the buffer
+ * \return The length of the record, or -1 if the buffer is empty
+ *
+ *         The record is removed from the ring buffer. If it is longer
+ *         than maxlen, only its first maxlen bytes are copied.
+ */
+int spsc_ringbuf_get_record(struct spsc_ringbuf *r,
+                            void *data, uint16_t maxlen);
+
+/**
+ * \brief Get the length of the next record. Called by the consumer only.
+ * \param r Pointer to the ring buffer
+ * \return The length of the next record, or -1 if the buffer is empty
+ */
+int spsc_ringbuf_peek_record(const struct spsc_ringbuf *r);
+
+/**
+ * \brief Get the size of a ring buffer
+ * \param r Pointer to the ring buffer
+ * \return The size of the buffer, in bytes
+ */
+int spsc_ringbuf_size(const struct spsc_ringbuf *r);
+
+/**
+ * \brief Get the number of bytes currently in the ring buffer
+ * \param r Pointer to the ring buffer
+ * \return The number of bytes in the buffer, including record headers
+ */
+int spsc_ringbuf_elements(const struct spsc_ringbuf *r);
+
+/**
+ * \brief Get the number of bytes that can be put in the ring buffer
+ * \param r Pointer to the ring buffer
+ * \return The free space in the buffer, in bytes
+ */
+int spsc_ringbuf_free(const struct spsc_ringbuf *r);
+
+#endif /* SPSC_RINGBUF_H_ */
+
+/** @}*/
+/** @}*/
@@ -63,6 +63,7 @@
 
 #include "contiki.h"
 #include "dev/watchdog.h"
+#include "lib/hash-map.h"
 #include "net/link-stats.h"
 #include "net/ipv6/uipopt.h"
 #include "net/ipv6/tcpip.h"
@@ -245,6 +246,10 @@ static uint16_t my_tag;
 #define SICSLOWPAN_REASS_CONTEXTS 2
 #endif
 
+#if SICSLOWPAN_REASS_CONTEXTS > 127
+#error "SICSLOWPAN_CONF_REASS_CONTEXTS must be at most 127"
+#endif
+
 /* The size of each fragment (IP payload) for the 6lowpan fragmentation */
 #ifdef SICSLOWPAN_CONF_FRAGMENT_SIZE
 #define SICSLOWPAN_FRAGMENT_SIZE SICSLOWPAN_CONF_FRAGMENT_SIZE
@@ -256,6 +261,17 @@ static uint16_t my_tag;
 /* Assuming that the worst growth for uncompression is 38 bytes */
 #define SICSLOWPAN_FIRST_FRAGMENT_SIZE (SICSLOWPAN_FRAGMENT_SIZE + 38)
 
+/* The number of reassembly contexts a single sender may hold, so that
+ * one sender cannot starve the others. A sender that has reached its
+ * quota, or that finds no free context, recycles its own oldest one:
+ * senders send their packets one after the other, so an older packet
+ * still incomplete when the next one starts has lost fragments. */
+#ifdef SICSLOWPAN_CONF_REASS_PER_SENDER
+#define SICSLOWPAN_REASS_PER_SENDER SICSLOWPAN_CONF_REASS_PER_SENDER
+#else
+#define SICSLOWPAN_REASS_PER_SENDER ((SICSLOWPAN_REASS_CONTEXTS + 1) / 2)
+#endif
+
 /* all information needed for reassembly */
 struct sicslowpan_frag_info {
   /** When reassembling, the source address of the fragments being merged */
@@ -270,8 +286,11 @@ struct sicslowpan_frag_info {
   uint16_t reassembled_len;
   /** Reassembly %process %timer. */
   struct timer reass_timer;
+  /** One plus the index of the next context with the same hash of
+      sender and tag, or zero */
+  uint8_t hash_next;
 
-  /** Fragment size of first fragment */
+  /** Fragment size of first fragment, zero until it is received */
   uint16_t first_frag_len;
   /** First fragment - needs a larger buffer since the size is uncompressed size
    and we need to know total size to know when we have received last fragment. */
@@ -280,6 +299,10 @@ struct sicslowpan_frag_info {
 
 static struct sicslowpan_frag_info frag_info[SICSLOWPAN_REASS_CONTEXTS];
 
+/* The contexts in use, chained by hash of sender and tag. As in
+   hash_next, the chains hold one plus the index of each context. */
+static uint8_t frag_info_hash[SICSLOWPAN_REASS_CONTEXTS];
+
 struct sicslowpan_frag_buf {
   /* the index of the frag_info */
   uint8_t index;
@@ -292,12 +315,47 @@ struct sicslowpan_frag_buf {
 
 static struct sicslowpan_frag_buf frag_buf[SICSLOWPAN_FRAGMENT_BUFFERS];
 
+struct sicslowpan_reass_stats sicslowpan_reass_stats;
+
+/*---------------------------------------------------------------------------*/
+static uint8_t *
+frag_info_bucket(const linkaddr_t *sender, uint16_t tag)
+{
+  return &frag_info_hash[(hash_map_hash(sender, LINKADDR_SIZE) ^ tag) %
+                         SICSLOWPAN_REASS_CONTEXTS];
+}
+/*---------------------------------------------------------------------------*/
+static int8_t
+find_context(const linkaddr_t *sender, uint16_t tag)
+{
+  uint8_t i;
+
+  for(i = *frag_info_bucket(sender, tag); i > 0; i = frag_info[i - 1].hash_next) {
+    if(frag_info[i - 1].tag == tag && linkaddr_cmp(&frag_info[i - 1].sender, sender)) {
+      return i - 1;
+    }
+  }
+  return -1;
+}
 /*---------------------------------------------------------------------------*/
 static int
 clear_fragments(uint8_t frag_info_index)
 {
   int i, clear_count;
+  uint8_t *l;
+
   clear_count = 0;
+  if(frag_info[frag_info_index].len > 0) {
+    /* Unlink the context from its hash chain */
+    l = frag_info_bucket(&frag_info[frag_info_index].sender,
+                         frag_info[frag_info_index].tag);
+    for(; *l > 0; l = &frag_info[*l - 1].hash_next) {
+      if(*l == frag_info_index + 1) {
+        *l = frag_info[frag_info_index].hash_next;
+        break;
+      }
+    }
+  }
   frag_info[frag_info_index].len = 0;
   for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
     if(frag_buf[i].len > 0 && frag_buf[i].index == frag_info_index) {
@@ -319,99 +377,170 @@ timeout_fragments(int not_context)
        timer_expired(&frag_info[i].reass_timer)) {
       /* This context can be freed */
       count += clear_fragments(i);
+      sicslowpan_reass_stats.timeouts++;
     }
   }
   return count;
 }
 /*---------------------------------------------------------------------------*/
+/* Returns the length of the stored fragment, 0 if it was already stored,
+   or -1 if it cannot be stored */
 static int
 store_fragment(uint8_t index, uint8_t offset)
 {
   int i;
+  int free_buf = -1;
+  int len = packetbuf_datalen() - packetbuf_hdr_len;
+
+  if(len <= 0 || len > SICSLOWPAN_FRAGMENT_SIZE) {
+    return -1;
+  }
   for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
     if(frag_buf[i].len == 0) {
-      /* copy over the data from packetbuf into the fragment buffer and store offset and len */
-      frag_buf[i].offset = offset; /* frag offset */
-      frag_buf[i].len = packetbuf_datalen() - packetbuf_hdr_len;
-      frag_buf[i].index = index;
-      memcpy(frag_buf[i].data, packetbuf_ptr + packetbuf_hdr_len,
-             packetbuf_datalen() - packetbuf_hdr_len);
-      /* return the length of the stored fragment */
-      return frag_buf[i].len;
+      if(free_buf < 0) {
+        free_buf = i;
+      }
+    } else if(frag_buf[i].index == index && frag_buf[i].offset == offset) {
+      /* A retransmission of a fragment we already have */
+      return 0;
     }
   }
-  /* failed */
-  return -1;
+  if(free_buf < 0) {
+    /* failed */
+    return -1;
+  }
+  /* copy over the data from packetbuf into the fragment buffer and store offset and len */
+  frag_buf[free_buf].offset = offset; /* frag offset */
+  frag_buf[free_buf].len = len;
+  frag_buf[free_buf].index = index;
+  memcpy(frag_buf[free_buf].data, packetbuf_ptr + packetbuf_hdr_len, len);
+  /* return the length of the stored fragment */
+  return len;
 }
 /*---------------------------------------------------------------------------*/
-/* add a new fragment to the buffer */
+/* Allocate a reassembly context for a new packet of the current sender */
 static int8_t
-add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
+new_context(uint16_t tag, uint16_t frag_size, uint8_t first)
 {
+  const linkaddr_t *sender = packetbuf_addr(PACKETBUF_ADDR_SENDER);
   int i;
-  int len;
   int8_t found = -1;
+  int8_t oldest_own = -1;
+  int own = 0;
+  uint8_t *head;
+
+  if(frag_size == 0) {
+    /* An empty packet would leave its context looking free */
+    LOG_WARN("reassembly: empty packet - tag: %d\n", tag);
+    sicslowpan_reass_stats.dropped++;
+    return -1;
+  }
+  if(frag_size > UIP_BUFSIZE - UIP_LLH_LEN) {
+    /* Hopeless from the start: the packet would not fit in uip_buf */
+    LOG_WARN("reassembly: packet too large - tag: %d len: %d\n", tag, frag_size);
+    sicslowpan_reass_stats.dropped++;
+    return -1;
+  }
 
-  if(offset == 0) {
-    /* This is a first fragment - check if we can add this */
-    for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
-      /* clear all fragment info with expired timer to free all fragment buffers */
-      if(frag_info[i].len > 0 && timer_expired(&frag_info[i].reass_timer)) {
-        clear_fragments(i);
-      }
+  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
+    /* clear all fragment info with expired timer to free all fragment buffers */
+    if(frag_info[i].len > 0 && timer_expired(&frag_info[i].reass_timer)) {
+      clear_fragments(i);
+      sicslowpan_reass_stats.timeouts++;
+    }
 
-      /* We use len as indication on used or not used */
-      if(found < 0 && frag_info[i].len == 0) {
-        /* We remember the first free fragment info but must continue
-           the loop to free any other expired fragment buffers. */
+    /* We use len as indication on used or not used */
+    if(frag_info[i].len == 0) {
+      /* We remember the first free fragment info but must continue
+         the loop to free any other expired fragment buffers. */
+      if(found < 0) {
         found = i;
       }
+    } else if(linkaddr_cmp(&frag_info[i].sender, sender)) {
+      own++;
+      if(oldest_own < 0 ||
+         timer_remaining(&frag_info[i].reass_timer) <
+         timer_remaining(&frag_info[oldest_own].reass_timer)) {
+        oldest_own = i;
+      }
     }
+  }
 
+  if(first && oldest_own >= 0 &&
+     (own >= SICSLOWPAN_REASS_PER_SENDER || found < 0)) {
+    /* The sender has moved on to a new packet: the oldest of its own
+       is most likely missing fragments, recycle its context */
+    LOG_WARN("reassembly: dropping older packet of sender - tag: %d\n",
+             frag_info[oldest_own].tag);
+    clear_fragments(oldest_own);
+    sicslowpan_reass_stats.evicted++;
+    found = oldest_own;
+  } else if(own >= SICSLOWPAN_REASS_PER_SENDER || found < 0) {
+    LOG_WARN("reassembly: failed to store new fragment session - tag: %d\n", tag);
+    sicslowpan_reass_stats.no_context++;
+    return -1;
+  }
+
+  /* Found a free fragment info to store data in */
+  frag_info[found].len = frag_size;
+  frag_info[found].tag = tag;
+  frag_info[found].reassembled_len = 0;
+  frag_info[found].first_frag_len = 0;
+  linkaddr_copy(&frag_info[found].sender, sender);
+  timer_set(&frag_info[found].reass_timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
+  head = frag_info_bucket(sender, tag);
+  frag_info[found].hash_next = *head;
+  *head = found + 1;
+  return found;
+}
+/*---------------------------------------------------------------------------*/
+/* add a new fragment to the buffer */
+static int8_t
+add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
+{
+  int len;
+  int8_t found;
+
+  found = find_context(packetbuf_addr(PACKETBUF_ADDR_SENDER), tag);
+  if(found < 0) {
+    /* The first fragment of a new packet, or a later one that overtook
+       it: either way, a new packet starts */
+    found = new_context(tag, frag_size, offset == 0);
     if(found < 0) {
-      LOG_WARN("reassembly: failed to store new fragment session - tag: %d\n", tag);
       return -1;
     }
+  }
 
-    /* Found a free fragment info to store data in */
-    frag_info[found].len = frag_size;
-    frag_info[found].tag = tag;
-    linkaddr_copy(&frag_info[found].sender,
-                  packetbuf_addr(PACKETBUF_ADDR_SENDER));
-    timer_set(&frag_info[found].reass_timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
+  if(offset == 0) {
+    if(frag_info[found].first_frag_len > 0) {
+      LOG_INFO("reassembly: duplicate first fragment - tag: %d\n", tag);
+      sicslowpan_reass_stats.duplicates++;
+      return -1;
+    }
     /* first fragment can not be stored immediately but is moved into
        the buffer while uncompressing */
     return found;
   }
 
-  /* This is a N-fragment - should find the info */
-  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
-    if(frag_info[i].tag == tag && frag_info[i].len > 0 &&
-       linkaddr_cmp(&frag_info[i].sender, packetbuf_addr(PACKETBUF_ADDR_SENDER))) {
-      /* Tag and Sender match - this must be the correct info to store in */
-      found = i;
-      break;
-    }
-  }
-
-  if(found < 0) {
-    /* no entry found for storing the new fragment */
-    LOG_WARN("reassembly: failed to store N-fragment - could not find session - tag: %d offset: %d\n", tag, offset);
-    return -1;
-  }
-
-  /* i is the index of the reassembly context */
-  len = store_fragment(i, offset);
-  if(len < 0 && timeout_fragments(i) > 0) {
-    len = store_fragment(i, offset);
+  /* This is a N-fragment - found is the index of the reassembly context */
+  len = store_fragment(found, offset);
+  if(len < 0 && timeout_fragments(found) > 0) {
+    len = store_fragment(found, offset);
   }
   if(len > 0) {
-    frag_info[i].reassembled_len += len;
-    return i;
+    frag_info[found].reassembled_len += len;
+    return found;
+  } else if(len == 0) {
+    LOG_INFO("reassembly: duplicate fragment - tag: %d offset: %d\n", tag, offset);
+    sicslowpan_reass_stats.duplicates++;
+    return -1;
   } else {
-    /* should we also clear all fragments since we failed to store
-       this fragment? */
-    LOG_WARN("reassembly: failed to store fragment - packet reassembly will fail tag:%d l\n", frag_info[i].tag);
+    /* With a fragment missing, the packet can never be reassembled:
+       free the context and its buffers for other packets right away */
+    LOG_WARN("reassembly: failed to store fragment - dropping packet tag: %d\n",
+             frag_info[found].tag);
+    clear_fragments(found);
+    sicslowpan_reass_stats.dropped++;
     return -1;
   }
 }
@@ -435,6 +564,7 @@ copy_frags2uip(int context)
   }
   /* deallocate all the fragments for this context */
   clear_fragments(context);
+  sicslowpan_reass_stats.reassembled++;
 }
 #endif /* SICSLOWPAN_CONF_FRAG */
 
@@ -1504,6 +1634,34 @@ send_packet(linkaddr_t *dest)
  */
 static int
 fragment_copy_payload_and_send(uint16_t uip_offset, linkaddr_t *dest) {
+#if PACKETBUF_NUM > 1
+  struct packetbuf *frag;
+  struct packetbuf *headers;
+
+  /* Build the fragment in a packet descriptor of its own, from the
+     headers prepared in packetbuf. Enables preserving attributes for
+     all fragments, without copying the fragment to a queuebuf and back */
+  frag = packetbuf_alloc();
+  if(frag == NULL) {
+    LOG_WARN("output: could not allocate packetbuf, dropping fragment\n");
+    return 0;
+  }
+  packetbuf_set_datalen(packetbuf_hdr_len);
+  headers = packetbuf_select(frag);
+  packetbuf_copyfrom_packetbuf(headers);
+
+  /* Now copy fragment payload from uip_buf */
+  memcpy((uint8_t *)packetbuf_dataptr() + packetbuf_hdr_len,
+         (uint8_t *)UIP_IP_BUF + uip_offset, packetbuf_payload_len);
+  packetbuf_set_datalen(packetbuf_payload_len + packetbuf_hdr_len);
+
+  /* Send fragment */
+  send_packet(dest);
+
+  /* Go back to the headers */
+  packetbuf_select(headers);
+  packetbuf_free(frag);
+#else /* PACKETBUF_NUM > 1 */
   struct queuebuf *q;
 
   /* Now copy fragment payload from uip_buf */
@@ -1524,6 +1682,9 @@ fragment_copy_payload_and_send(uint16_t uip_offset, linkaddr_t *dest) {
   /* Restore packetbuf from queuebuf */
   queuebuf_to_packetbuf(q);
   queuebuf_free(q);
+  /* The packetbuf may now use the queuebuf's storage */
+  packetbuf_ptr = packetbuf_dataptr();
+#endif /* PACKETBUF_NUM > 1 */
 
   /* Check tx result. */
   if((last_tx_status == MAC_TX_COLLISION) ||
@@ -1663,7 +1824,9 @@ output(const linkaddr_t *localdest)
       fragment_count += 1 + (middle_fragn_total_payload - 1) / fragn_max_payload;
     }
 
-    int freebuf = queuebuf_numfree() - 1;
+    /* One queuebuf is used to backup packetbuf, unless the fragments
+       are built in packet descriptors of their own */
+    int freebuf = queuebuf_numfree() - (PACKETBUF_NUM > 1 ? 0 : 1);
     LOG_INFO("output: fragmentation needed, fragments: %u, free queuebufs: %u\n",
       fragment_count, freebuf);
 
@@ -1835,7 +1998,7 @@ input(void)
       frag_context = add_fragment(frag_tag, frag_size, frag_offset);
 
       if(frag_context == -1) {
-        LOG_ERR("input: failed to allocate new reassembly context\n");
+        LOG_ERR("input: first fragment dropped (tag %d)\n", frag_tag);
         return;
       }
 
@@ -1857,7 +2020,7 @@ input(void)
       frag_context = add_fragment(frag_tag, frag_size, frag_offset);
 
       if(frag_context == -1) {
-        LOG_ERR("input: reassembly context not found (tag %d)\n", frag_tag);
+        LOG_ERR("input: fragment dropped (tag %d)\n", frag_tag);
         return;
       }
 
@@ -1865,7 +2028,10 @@ input(void)
          we should not store more */
       buffer = NULL;
 
-      if(frag_info[frag_context].reassembled_len >= frag_size) {
+      /* Fragments may arrive out of order: the packet is complete once
+         the first fragment and enough of the others are in */
+      if(frag_info[frag_context].first_frag_len > 0 &&
+         frag_info[frag_context].reassembled_len >= frag_size) {
         last_fragment = 1;
       }
       is_fragment = 1;
@@ -1959,8 +2125,12 @@ input(void)
   if(frag_size > 0) {
     /* Add the size of the header only for the first fragment. */
     if(first_fragment != 0) {
-      frag_info[frag_context].reassembled_len = uncomp_hdr_len + packetbuf_payload_len;
+      frag_info[frag_context].reassembled_len += uncomp_hdr_len + packetbuf_payload_len;
       frag_info[frag_context].first_frag_len = uncomp_hdr_len + packetbuf_payload_len;
+      if(frag_info[frag_context].reassembled_len >= frag_size) {
+        /* The first fragment was the last one missing */
+        last_fragment = 1;
+      }
     }
     /* For the last fragment, we are OK if there is extrenous bytes at
        the end of the packet. */
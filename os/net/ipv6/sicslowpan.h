@@ -334,6 +334,27 @@ struct sicslowpan_nh_compressor {
 
 };
 
+/**
+ * The statistics of 6LoWPAN reassembly: what became of the fragmented
+ * packets received.
+ */
+struct sicslowpan_reass_stats {
+  uint16_t reassembled; /**< Number of packets reassembled. */
+  uint16_t timeouts;    /**< Number of packets timed out incomplete. */
+  uint16_t no_context;  /**< Number of packets dropped for lack of a
+                             reassembly context. */
+  uint16_t evicted;     /**< Number of incomplete packets dropped for a
+                             newer one of the same sender. */
+  uint16_t dropped;     /**< Number of packets dropped because they were
+                             too large or a fragment could not be
+                             stored. */
+  uint16_t duplicates;  /**< Number of duplicate fragments ignored. */
+};
+
+#if SICSLOWPAN_CONF_FRAG
+extern struct sicslowpan_reass_stats sicslowpan_reass_stats;
+#endif /* SICSLOWPAN_CONF_FRAG */
+
 int sicslowpan_get_last_rssi(void);
 
 extern const struct network_driver sicslowpan_driver;
@@ -44,6 +44,7 @@
 
 #include "lib/list.h"
 #include "lib/memb.h"
+#include "lib/hash-map.h"
 #include "net/nbr-table.h"
 
 /* Log configuration */
@@ -91,6 +92,17 @@ MEMB(routememb, uip_ds6_route_t, UIP_DS6_ROUTE_NB);
 static int num_routes = 0;
 static void rm_routelist_callback(nbr_table_item_t *ptr);
 
+#if UIP_DS6_ROUTE_HASH_BUCKETS
+#if UIP_DS6_ROUTE_HASH_BUCKETS & (UIP_DS6_ROUTE_HASH_BUCKETS - 1)
+#error UIP_DS6_ROUTE_CONF_HASH_BUCKETS must be a power of two
+#endif
+/* The host routes, indexed by interface identifier, and the other
+   routes, sorted by decreasing prefix length. Both are chained through
+   the index_next field of the routes. */
+static uip_ds6_route_t *host_routes[UIP_DS6_ROUTE_HASH_BUCKETS];
+static uip_ds6_route_t *prefix_routes;
+#endif /* UIP_DS6_ROUTE_HASH_BUCKETS */
+
 #endif /* (UIP_MAX_ROUTES != 0) */
 
 /* Default routes are held on the defaultrouterlist and their
@@ -174,6 +186,10 @@ uip_ds6_route_init(void)
 #if (UIP_MAX_ROUTES != 0)
   memb_init(&routememb);
   list_init(routelist);
+#if UIP_DS6_ROUTE_HASH_BUCKETS
+  memset(host_routes, 0, sizeof(host_routes));
+  prefix_routes = NULL;
+#endif /* UIP_DS6_ROUTE_HASH_BUCKETS */
   nbr_table_register(nbr_routes,
                      (nbr_table_callback *)rm_routelist_callback);
 #endif /* (UIP_MAX_ROUTES != 0) */
@@ -197,6 +213,69 @@ uip_ds6_route_nexthop_lladdr(uip_ds6_route_t *route)
     return NULL;
   }
 }
+#if UIP_DS6_ROUTE_HASH_BUCKETS
+/*---------------------------------------------------------------------------*/
+/* Host routes under different prefixes can share an interface identifier */
+static uip_ds6_route_t **
+host_bucket(const uip_ipaddr_t *addr)
+{
+  return &host_routes[hash_map_hash(&addr->u8[8], 8) &
+                      (UIP_DS6_ROUTE_HASH_BUCKETS - 1)];
+}
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t **
+index_head(const uip_ds6_route_t *route)
+{
+  return route->length == 128 ? host_bucket(&route->ipaddr) : &prefix_routes;
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_add(uip_ds6_route_t *route)
+{
+  uip_ds6_route_t **l = index_head(route);
+
+  if(route->length != 128) {
+    /* Longest prefixes first, so that the first match is the longest */
+    while(*l != NULL && (*l)->length >= route->length) {
+      l = &(*l)->index_next;
+    }
+  }
+  route->index_next = *l;
+  *l = route;
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_remove(uip_ds6_route_t *route)
+{
+  uip_ds6_route_t **l;
+
+  for(l = index_head(route); *l != NULL; l = &(*l)->index_next) {
+    if(*l == route) {
+      *l = route->index_next;
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t *
+index_lookup(const uip_ipaddr_t *addr)
+{
+  uip_ds6_route_t *r;
+
+  /* A host route is always the longest match */
+  for(r = *host_bucket(addr); r != NULL; r = r->index_next) {
+    if(uip_ipaddr_cmp(addr, &r->ipaddr)) {
+      return r;
+    }
+  }
+  for(r = prefix_routes; r != NULL; r = r->index_next) {
+    if(uip_ipaddr_prefixcmp(addr, &r->ipaddr, r->length)) {
+      return r;
+    }
+  }
+  return NULL;
+}
+#endif /* UIP_DS6_ROUTE_HASH_BUCKETS */
 #endif /* (UIP_MAX_ROUTES != 0) */
 /*---------------------------------------------------------------------------*/
 const uip_ipaddr_t *
@@ -266,9 +345,11 @@ uip_ds6_route_t *
 uip_ds6_route_lookup(const uip_ipaddr_t *addr)
 {
 #if (UIP_MAX_ROUTES != 0)
-  uip_ds6_route_t *r;
   uip_ds6_route_t *found_route;
+#if !UIP_DS6_ROUTE_HASH_BUCKETS
+  uip_ds6_route_t *r;
   uint8_t longestmatch;
+#endif /* !UIP_DS6_ROUTE_HASH_BUCKETS */
 
   LOG_INFO("Looking up route for ");
   LOG_INFO_6ADDR(addr);
@@ -278,6 +359,9 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     return NULL;
   }
 
+#if UIP_DS6_ROUTE_HASH_BUCKETS
+  found_route = index_lookup(addr);
+#else /* UIP_DS6_ROUTE_HASH_BUCKETS */
   found_route = NULL;
   longestmatch = 0;
   for(r = uip_ds6_route_head();
@@ -293,6 +377,7 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
       }
     }
   }
+#endif /* UIP_DS6_ROUTE_HASH_BUCKETS */
 
   if(found_route != NULL) {
     LOG_INFO("Found route: ");
@@ -304,6 +389,9 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     LOG_WARN("No route found\n");
   }
 
+#if !UIP_DS6_ROUTE_HASH_BUCKETS || UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+  /* With the index, the order of the list no longer speeds lookups up,
+     and is only kept when the least recently used route gets evicted */
   if(found_route != NULL && found_route != list_head(routelist)) {
     /* If we found a route, we put it at the start of the routeslist
        list. The list is ordered by how recently we looked them up:
@@ -313,6 +401,7 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     list_remove(routelist, found_route);
     list_push(routelist, found_route);
   }
+#endif /* !UIP_DS6_ROUTE_HASH_BUCKETS || UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED */
 
   return found_route;
 #else /* (UIP_MAX_ROUTES != 0) */
@@ -455,6 +544,9 @@ uip_ds6_route_add(const uip_ipaddr_t *ipaddr, uint8_t length,
 
   uip_ipaddr_copy(&(r->ipaddr), ipaddr);
   r->length = length;
+#if UIP_DS6_ROUTE_HASH_BUCKETS
+  index_add(r);
+#endif /* UIP_DS6_ROUTE_HASH_BUCKETS */
 
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   memset(&r->state, 0, sizeof(UIP_DS6_ROUTE_STATE_TYPE));
@@ -500,6 +592,9 @@ uip_ds6_route_rm(uip_ds6_route_t *route)
 
     /* Remove the route from the route list */
     list_remove(routelist, route);
+#if UIP_DS6_ROUTE_HASH_BUCKETS
+    index_remove(route);
+#endif /* UIP_DS6_ROUTE_HASH_BUCKETS */
 
     /* Find the corresponding neighbor_route and remove it. */
     for(neighbor_route = list_head(route->neighbor_routes->route_list);
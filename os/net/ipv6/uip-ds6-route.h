@@ -111,6 +111,16 @@ void uip_ds6_notification_rm(struct uip_ds6_notification *n);
 #define UIP_DS6_ROUTE_NB 4
 #endif /* UIP_MAX_ROUTES */
 
+/* The number of buckets of the hash index of host (/128) routes: a power
+   of two, or 0 to look all routes up by walking the routing table. With
+   the index, host routes are found in a single bucket and only the
+   shorter prefixes are walked, longest first. */
+#ifdef UIP_DS6_ROUTE_CONF_HASH_BUCKETS
+#define UIP_DS6_ROUTE_HASH_BUCKETS UIP_DS6_ROUTE_CONF_HASH_BUCKETS
+#else /* UIP_DS6_ROUTE_CONF_HASH_BUCKETS */
+#define UIP_DS6_ROUTE_HASH_BUCKETS 0
+#endif /* UIP_DS6_ROUTE_CONF_HASH_BUCKETS */
+
 /** \brief define some additional RPL related route state and
  *  neighbor callback for RPL - if not a DS6_ROUTE_STATE is already set */
 #ifndef UIP_DS6_ROUTE_STATE_TYPE
@@ -181,6 +191,11 @@ typedef struct uip_ds6_route {
   UIP_DS6_ROUTE_STATE_TYPE state;
 #endif
   uint8_t length;
+#if UIP_DS6_ROUTE_HASH_BUCKETS
+  /* The next host route in the same bucket of the hash index, or the
+     next shorter prefix route */
+  struct uip_ds6_route *index_next;
+#endif /* UIP_DS6_ROUTE_HASH_BUCKETS */
 } uip_ds6_route_t;
 
 /** \brief A neighbor route list entry, used on the
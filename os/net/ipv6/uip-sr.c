@@ -45,6 +45,9 @@
 #include "net/routing/routing.h"
 #include "lib/list.h"
 #include "lib/memb.h"
+#include "lib/hash-map.h"
+
+#include <string.h>
 
 /* Log configuration */
 #include "sys/log.h"
@@ -58,6 +61,27 @@ static int num_nodes;
 LIST(nodelist);
 MEMB(nodememb, uip_sr_node_t, UIP_SR_LINK_NUM);
 
+#if UIP_SR_HASH_BUCKETS
+#if UIP_SR_HASH_BUCKETS & (UIP_SR_HASH_BUCKETS - 1)
+#error UIP_SR_CONF_HASH_BUCKETS must be a power of two
+#endif
+/* The nodes, indexed by interface identifier */
+static uip_sr_node_t *buckets[UIP_SR_HASH_BUCKETS];
+#endif /* UIP_SR_HASH_BUCKETS */
+
+#if UIP_SR_SRH_CACHE_SIZE
+#if UIP_SR_SRH_CACHE_SIZE & (UIP_SR_SRH_CACHE_SIZE - 1)
+#error UIP_SR_CONF_SRH_CACHE_SIZE must be a power of two
+#endif
+/* Direct-mapped: the slot of a destination depends on its identifier only */
+static uip_sr_srh_t srh_cache[UIP_SR_SRH_CACHE_SIZE];
+/* Bumped on every topology change, which invalidates all cached headers */
+static uint32_t generation;
+#define TOPOLOGY_CHANGED() generation++
+#else /* UIP_SR_SRH_CACHE_SIZE */
+#define TOPOLOGY_CHANGED()
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+
 /*---------------------------------------------------------------------------*/
 int
 uip_sr_num_nodes(void)
@@ -77,16 +101,65 @@ node_matches_address(void *graph, const uip_sr_node_t *node, const uip_ipaddr_t
   }
 }
 /*---------------------------------------------------------------------------*/
+#if UIP_SR_HASH_BUCKETS
+/* Several nodes may have the same identifier, in different graphs,
+   which a hash_map does not allow: the index has its own buckets */
+static uip_sr_node_t **
+bucket(const unsigned char *link_identifier)
+{
+  return &buckets[hash_map_hash(link_identifier, 8) & (UIP_SR_HASH_BUCKETS - 1)];
+}
+/*---------------------------------------------------------------------------*/
+static void
+unindex_node(uip_sr_node_t *node)
+{
+  uip_sr_node_t **l;
+
+  for(l = bucket(node->link_identifier); *l != NULL; l = &(*l)->hash_next) {
+    if(*l == node) {
+      *l = node->hash_next;
+      return;
+    }
+  }
+}
+#endif /* UIP_SR_HASH_BUCKETS */
+/*---------------------------------------------------------------------------*/
+static void
+remove_node(uip_sr_node_t *node)
+{
+#if UIP_SR_HASH_BUCKETS
+  unindex_node(node);
+#endif /* UIP_SR_HASH_BUCKETS */
+  list_remove(nodelist, node);
+  memb_free(&nodememb, node);
+  num_nodes--;
+  TOPOLOGY_CHANGED();
+}
+/*---------------------------------------------------------------------------*/
 uip_sr_node_t *
 uip_sr_get_node(void *graph, const uip_ipaddr_t *addr)
 {
   uip_sr_node_t *l;
+
+#if UIP_SR_HASH_BUCKETS
+  if(addr == NULL) {
+    return NULL;
+  }
+  for(l = *bucket(&addr->u8[8]); l != NULL; l = l->hash_next) {
+    /* Compare the node identifier first, as it is cheaper */
+    if(memcmp(l->link_identifier, &addr->u8[8], 8) == 0 &&
+       node_matches_address(graph, l, addr)) {
+      return l;
+    }
+  }
+#else /* UIP_SR_HASH_BUCKETS */
   for(l = list_head(nodelist); l != NULL; l = list_item_next(l)) {
     /* Compare prefix and node identifier */
     if(node_matches_address(graph, l, addr)) {
       return l;
     }
   }
+#endif /* UIP_SR_HASH_BUCKETS */
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
@@ -116,6 +189,7 @@ uip_sr_expire_parent(void *graph, const uip_ipaddr_t *child, const uip_ipaddr_t
   /* Check if parent matches */
   if(l != NULL && node_matches_address(graph, l->parent, parent)) {
     l->lifetime = UIP_SR_REMOVAL_DELAY;
+    TOPOLOGY_CHANGED();
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -125,6 +199,10 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child, const uip_ipaddr_t *p
   uip_sr_node_t *child_node = uip_sr_get_node(graph, child);
   uip_sr_node_t *parent_node = uip_sr_get_node(graph, parent);
   uip_sr_node_t *old_parent_node;
+  void *old_graph;
+#if UIP_SR_HASH_BUCKETS
+  uip_sr_node_t **head;
+#endif /* UIP_SR_HASH_BUCKETS */
 
   if(parent != NULL) {
     /* No node for the parent, add one with infinite lifetime */
@@ -147,19 +225,26 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child, const uip_ipaddr_t *p
       LOG_ERR_("\n");
       return NULL;
     }
+    child_node->graph = graph;
     child_node->parent = NULL;
+    memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
     list_add(nodelist, child_node);
     num_nodes++;
+#if UIP_SR_HASH_BUCKETS
+    head = bucket(child_node->link_identifier);
+    child_node->hash_next = *head;
+    *head = child_node;
+#endif /* UIP_SR_HASH_BUCKETS */
   }
 
   /* Initialize node */
+  old_graph = child_node->graph;
+  old_parent_node = child_node->parent;
   child_node->graph = graph;
   child_node->lifetime = lifetime;
-  memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
 
   /* Is the node reachable before the update? */
   if(uip_sr_is_addr_reachable(graph, child)) {
-    old_parent_node = child_node->parent;
     /* Update node */
     child_node->parent = parent_node;
     /* Has the node become unreachable? May happen if we create a loop. */
@@ -173,6 +258,11 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child, const uip_ipaddr_t *p
     child_node->parent = parent_node;
   }
 
+  /* Most updates are refreshes, only actual changes invalidate routes */
+  if(child_node->parent != old_parent_node || child_node->graph != old_graph) {
+    TOPOLOGY_CHANGED();
+  }
+
   LOG_INFO("NS: updating link, child ");
   LOG_INFO_6ADDR(child);
   LOG_INFO_(", parent ");
@@ -188,6 +278,13 @@ uip_sr_init(void)
   num_nodes = 0;
   memb_init(&nodememb);
   list_init(nodelist);
+#if UIP_SR_HASH_BUCKETS
+  memset(buckets, 0, sizeof(buckets));
+#endif /* UIP_SR_HASH_BUCKETS */
+#if UIP_SR_SRH_CACHE_SIZE
+  memset(srh_cache, 0, sizeof(srh_cache));
+  generation = 1;
+#endif /* UIP_SR_SRH_CACHE_SIZE */
 }
 /*---------------------------------------------------------------------------*/
 uip_sr_node_t *
@@ -201,6 +298,45 @@ uip_sr_node_next(uip_sr_node_t *item)
 {
   return list_item_next(item);
 }
+#if UIP_SR_SRH_CACHE_SIZE
+/*---------------------------------------------------------------------------*/
+static uip_sr_srh_t *
+srh_slot(const uip_ipaddr_t *dest)
+{
+  return &srh_cache[hash_map_hash(&dest->u8[8], 8) & (UIP_SR_SRH_CACHE_SIZE - 1)];
+}
+/*---------------------------------------------------------------------------*/
+const uip_sr_srh_t *
+uip_sr_srh_lookup(void *graph, const uip_ipaddr_t *dest)
+{
+  const uip_sr_srh_t *srh = srh_slot(dest);
+
+  if(srh->generation == generation && srh->graph == graph &&
+     uip_ipaddr_cmp(&srh->dest, dest)) {
+    return srh;
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_sr_srh_store(void *graph, const uip_ipaddr_t *dest,
+                 const uip_ipaddr_t *first_hop,
+                 const uint8_t *hdr, uint8_t len)
+{
+  uip_sr_srh_t *srh;
+
+  if(len > UIP_SR_SRH_CACHE_HDR_LEN) {
+    return;
+  }
+  srh = srh_slot(dest);
+  srh->graph = graph;
+  uip_ipaddr_copy(&srh->dest, dest);
+  uip_ipaddr_copy(&srh->first_hop, first_hop);
+  memcpy(srh->hdr, hdr, len);
+  srh->len = len;
+  srh->generation = generation;
+}
+#endif /* UIP_SR_SRH_CACHE_SIZE */
 /*---------------------------------------------------------------------------*/
 void
 uip_sr_periodic(unsigned seconds)
@@ -226,9 +362,7 @@ uip_sr_periodic(unsigned seconds)
         LOG_INFO_("\n");
       }
       /* No child found, deallocate node */
-      list_remove(nodelist, l);
-      memb_free(&nodememb, l);
-      num_nodes--;
+      remove_node(l);
     } else if(l->lifetime != UIP_SR_INFINITE_LIFETIME) {
       l->lifetime = l->lifetime > seconds ? l->lifetime - seconds : 0;
     }
@@ -242,9 +376,7 @@ uip_sr_free_all(void)
   uip_sr_node_t *next;
   for(l = list_head(nodelist); l != NULL; l = next) {
     next = list_item_next(l);
-    list_remove(nodelist, l);
-    memb_free(&nodememb, l);
-    num_nodes--;
+    remove_node(l);
   }
 }
 /*---------------------------------------------------------------------------*/
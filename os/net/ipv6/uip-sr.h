@@ -83,6 +83,33 @@
 #define UIP_SR_REMOVAL_DELAY          60
 #endif /* UIP_SR_CONF_REMOVAL_DELAY */
 
+/* The number of buckets of the hash index of the nodes, by interface
+   identifier: a power of two, or 0 to look nodes up by walking the whole
+   list. With the index, finding a node no longer depends on the network
+   size, which matters for roots of large networks. */
+#ifdef UIP_SR_CONF_HASH_BUCKETS
+#define UIP_SR_HASH_BUCKETS           UIP_SR_CONF_HASH_BUCKETS
+#else /* UIP_SR_CONF_HASH_BUCKETS */
+#define UIP_SR_HASH_BUCKETS           0
+#endif /* UIP_SR_CONF_HASH_BUCKETS */
+
+/* The number of source routing headers the root caches, by destination:
+   a power of two, or 0 to build the header from the graph for every
+   downward packet. Cached headers are dropped whenever the topology
+   changes, so the cost of a hit does not depend on the path length. */
+#ifdef UIP_SR_CONF_SRH_CACHE_SIZE
+#define UIP_SR_SRH_CACHE_SIZE         UIP_SR_CONF_SRH_CACHE_SIZE
+#else /* UIP_SR_CONF_SRH_CACHE_SIZE */
+#define UIP_SR_SRH_CACHE_SIZE         0
+#endif /* UIP_SR_CONF_SRH_CACHE_SIZE */
+
+/* The longest source routing header that is cached, in bytes */
+#ifdef UIP_SR_CONF_SRH_CACHE_HDR_LEN
+#define UIP_SR_SRH_CACHE_HDR_LEN      UIP_SR_CONF_SRH_CACHE_HDR_LEN
+#else /* UIP_SR_CONF_SRH_CACHE_HDR_LEN */
+#define UIP_SR_SRH_CACHE_HDR_LEN      64
+#endif /* UIP_SR_CONF_SRH_CACHE_HDR_LEN */
+
 #define UIP_SR_INFINITE_LIFETIME           0xFFFFFFFF
 
 /********** Data Structures  **********/
@@ -98,8 +125,26 @@ typedef struct uip_sr_node {
   us with the prefix */
   unsigned char link_identifier[8];
   struct uip_sr_node *parent;
+#if UIP_SR_HASH_BUCKETS
+  /* The next node in the same bucket of the hash index */
+  struct uip_sr_node *hash_next;
+#endif /* UIP_SR_HASH_BUCKETS */
 } uip_sr_node_t;
 
+#if UIP_SR_SRH_CACHE_SIZE
+/** \brief A routing header built by the root for a destination, along with
+ * the first hop, which becomes the IPv6 destination of the packet */
+typedef struct uip_sr_srh {
+  void *graph;
+  uip_ipaddr_t dest;
+  uip_ipaddr_t first_hop;
+  /* The graph generation the header was built in */
+  uint32_t generation;
+  uint8_t len;
+  uint8_t hdr[UIP_SR_SRH_CACHE_HDR_LEN];
+} uip_sr_srh_t;
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+
 /********** Public functions **********/
 
 /**
@@ -162,6 +207,33 @@ uip_sr_node_t *uip_sr_get_node(void *graph, const uip_ipaddr_t *addr);
 */
 int uip_sr_is_addr_reachable(void *graph, const uip_ipaddr_t *addr);
 
+#if UIP_SR_SRH_CACHE_SIZE
+/**
+ * Looks up for the cached source routing header of a destination. A header
+ * is only returned if the graph has not changed since it was stored.
+ *
+ * \param graph The graph of the destination
+ * \param dest The IPv6 global address of the destination
+ * \return The cached header, or NULL if there is none
+*/
+const uip_sr_srh_t *uip_sr_srh_lookup(void *graph, const uip_ipaddr_t *dest);
+
+/**
+ * Caches the source routing header of a destination, in place of
+ * whichever header was cached in its slot. Headers longer than
+ * UIP_SR_SRH_CACHE_HDR_LEN are not cached.
+ *
+ * \param graph The graph of the destination
+ * \param dest The IPv6 global address of the destination
+ * \param first_hop The IPv6 address of the first hop of the route
+ * \param hdr The routing header, as inserted in the packet
+ * \param len The length of the routing header, in bytes
+*/
+void uip_sr_srh_store(void *graph, const uip_ipaddr_t *dest,
+                      const uip_ipaddr_t *first_hop,
+                      const uint8_t *hdr, uint8_t len);
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+
 /**
  * A function called periodically. Used to age the links (decrease lifetime
  * and expire links accordingly)
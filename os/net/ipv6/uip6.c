@@ -298,6 +298,61 @@ uip_add32(uint8_t *op32, uint16_t op16)
 
 #if ! UIP_ARCH_CHKSUM
 /*---------------------------------------------------------------------------*/
+#if UIP_CHKSUM_WIDE
+static uint16_t
+chksum(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  /* The one's complement sum does not depend on the byte order (RFC 1071):
+   * sum words as they are in memory, and swap the result at the end. With
+   * 32-bit words added into 64 bits, carries pile up in the upper half
+   * and are folded back once, instead of being tested at every word. */
+  uint64_t acc = 0;
+  uint32_t w;
+  uint16_t h;
+  uint8_t last[2];
+  const uint8_t *end = data + len;
+
+  while(end - data >= 16) {
+    memcpy(&w, data, 4);
+    acc += w;
+    memcpy(&w, data + 4, 4);
+    acc += w;
+    memcpy(&w, data + 8, 4);
+    acc += w;
+    memcpy(&w, data + 12, 4);
+    acc += w;
+    data += 16;
+  }
+  while(end - data >= 4) {
+    memcpy(&w, data, 4);
+    acc += w;
+    data += 4;
+  }
+  if(end - data >= 2) {
+    memcpy(&h, data, 2);
+    acc += h;
+    data += 2;
+  }
+  if(data < end) {
+    /* Pad the odd byte with zero, as the low-order byte of its word */
+    last[0] = *data;
+    last[1] = 0;
+    memcpy(&h, last, 2);
+    acc += h;
+  }
+
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+
+  /* Back in host byte order, add the sum so far */
+  acc = (uint32_t)uip_ntohs((uint16_t)acc) + sum;
+  acc = (acc >> 16) + (acc & 0xffff);
+
+  return (uint16_t)acc;
+}
+#else /* UIP_CHKSUM_WIDE */
 static uint16_t
 chksum(uint16_t sum, const uint8_t *data, uint16_t len)
 {
@@ -328,6 +383,7 @@ chksum(uint16_t sum, const uint8_t *data, uint16_t len)
   /* Return sum in host byte order. */
   return sum;
 }
+#endif /* UIP_CHKSUM_WIDE */
 /*---------------------------------------------------------------------------*/
 uint16_t
 uip_chksum(uint16_t *data, uint16_t len)
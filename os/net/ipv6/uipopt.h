@@ -613,6 +613,21 @@ void uip_log(char *msg);
 #define UIP_BYTE_ORDER     (UIP_LITTLE_ENDIAN)
 #endif /* UIP_CONF_BYTE_ORDER */
 
+/**
+ * Whether the Internet checksum sums 32-bit words into a 64-bit
+ * accumulator, folding the carries once at the end, rather than one
+ * 16-bit word at a time with a carry test each. This pays off on
+ * 32-bit and 64-bit CPUs, but not on 8-bit and 16-bit ones. Platforms
+ * with a hand-written checksum set UIP_ARCH_CHKSUM instead.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_CHKSUM_WIDE
+#define UIP_CHKSUM_WIDE    (UIP_CONF_CHKSUM_WIDE)
+#else /* UIP_CONF_CHKSUM_WIDE */
+#define UIP_CHKSUM_WIDE    0
+#endif /* UIP_CONF_CHKSUM_WIDE */
+
 /** @} */
 /*------------------------------------------------------------------------------*/
 
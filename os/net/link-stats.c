@@ -229,6 +229,9 @@ link_stats_input_callback(const linkaddr_t *lladdr)
     return;
   }
 
+  /* Let the neighbor table know that the neighbor is active */
+  nbr_table_touch(link_stats, stats);
+
   /* Update RSSI EWMA */
   stats->rssi = ((int32_t)stats->rssi * (EWMA_SCALE - EWMA_ALPHA) +
       (int32_t)packet_rssi * EWMA_ALPHA) / EWMA_SCALE;
@@ -38,6 +38,7 @@
 #include <string.h>
 #include "lib/memb.h"
 #include "lib/list.h"
+#include "lib/hash-map.h"
 #include "net/nbr-table.h"
 
 #define DEBUG 0
@@ -65,6 +66,13 @@ const linkaddr_t *NBR_TABLE_FIND_REMOVABLE(nbr_table_reason_t reason, void *data
 typedef struct nbr_table_key {
   struct nbr_table_key *next;
   linkaddr_t lladdr;
+#if NBR_TABLE_LRU_EVICTION
+  /* Links in the eviction bucket of the neighbor */
+  struct nbr_table_key *lru_prev;
+  struct nbr_table_key *lru_next;
+  clock_time_t last_seen;
+  uint8_t bucket;
+#endif /* NBR_TABLE_LRU_EVICTION */
 } nbr_table_key_t;
 
 /* For each neighbor, a map of the tables that use the neighbor.
@@ -79,10 +87,26 @@ static struct nbr_table *all_tables[MAX_NUM_TABLES];
 /* The current number of tables */
 static unsigned num_tables;
 
+#if NBR_TABLE_LRU_EVICTION
+/* The bucket of locked neighbors, which are never evicted */
+#define NO_BUCKET 0xff
+/* The unlocked neighbors, in one bucket per number of tables using
+ * them, each ordered from the least to the most recently seen */
+static nbr_table_key_t *bucket_head[MAX_NUM_TABLES + 1];
+static nbr_table_key_t *bucket_tail[MAX_NUM_TABLES + 1];
+#endif /* NBR_TABLE_LRU_EVICTION */
+
 /* The neighbor address table */
 MEMB(neighbor_addr_mem, nbr_table_key_t, NBR_TABLE_MAX_NEIGHBORS);
 LIST(nbr_table_keys);
 
+#if NBR_TABLE_WITH_HASH
+/* Open-addressing hash index of the keys, by link-layer address, with
+ * linear probing. Each slot holds 1 + the index of a key, or 0 if the
+ * slot is empty. */
+static uint16_t hash_index[NBR_TABLE_HASH_SIZE];
+#endif /* NBR_TABLE_WITH_HASH */
+
 /*---------------------------------------------------------------------------*/
 /* Get a key from a neighbor index */
 static nbr_table_key_t *
@@ -126,16 +150,88 @@ key_from_item(nbr_table_t *table, const nbr_table_item_t *item)
   return key_from_index(index_from_item(table, item));
 }
 /*---------------------------------------------------------------------------*/
+#if NBR_TABLE_WITH_HASH
+/* Get the home slot of a link-layer address in the hash index */
+static unsigned
+hash_slot(const linkaddr_t *lladdr)
+{
+  return hash_map_hash(lladdr, LINKADDR_SIZE) % NBR_TABLE_HASH_SIZE;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned
+hash_next_slot(unsigned slot)
+{
+  return slot + 1 < NBR_TABLE_HASH_SIZE ? slot + 1 : 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Add a key to the hash index, once its link-layer address is set */
+static void
+hash_add(nbr_table_key_t *key)
+{
+  unsigned slot;
+
+  for(slot = hash_slot(&key->lladdr);
+      hash_index[slot] != 0;
+      slot = hash_next_slot(slot));
+  hash_index[slot] = index_from_key(key) + 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Remove a key from the hash index */
+static void
+hash_remove(nbr_table_key_t *key)
+{
+  unsigned slot, next, home;
+  uint16_t entry = index_from_key(key) + 1;
+
+  for(slot = hash_slot(&key->lladdr);
+      hash_index[slot] != entry;
+      slot = hash_next_slot(slot)) {
+    if(hash_index[slot] == 0) {
+      /* Not indexed */
+      return;
+    }
+  }
+
+  /* Shift back the entries that follow in the same probe sequence,
+   * so that no lookup stops early at the emptied slot. */
+  for(next = hash_next_slot(slot);
+      hash_index[next] != 0;
+      next = hash_next_slot(next)) {
+    home = hash_slot(&key_from_index(hash_index[next] - 1)->lladdr);
+    /* Move the entry unless its home slot lies cyclically in (slot, next] */
+    if((slot < next) ? (home <= slot || home > next)
+                     : (home <= slot && home > next)) {
+      hash_index[slot] = hash_index[next];
+      slot = next;
+    }
+  }
+  hash_index[slot] = 0;
+}
+#endif /* NBR_TABLE_WITH_HASH */
+/*---------------------------------------------------------------------------*/
 /* Get the index of a neighbor from its link-layer address */
 static int
 index_from_lladdr(const linkaddr_t *lladdr)
 {
+#if NBR_TABLE_WITH_HASH
+  unsigned slot;
+#else /* NBR_TABLE_WITH_HASH */
   nbr_table_key_t *key;
+#endif /* NBR_TABLE_WITH_HASH */
   /* Allow lladdr-free insertion, useful e.g. for IPv6 ND.
    * Only one such entry is possible at a time, indexed by linkaddr_null. */
   if(lladdr == NULL) {
     lladdr = &linkaddr_null;
   }
+#if NBR_TABLE_WITH_HASH
+  for(slot = hash_slot(lladdr);
+      hash_index[slot] != 0;
+      slot = hash_next_slot(slot)) {
+    if(linkaddr_cmp(lladdr, &key_from_index(hash_index[slot] - 1)->lladdr)) {
+      return hash_index[slot] - 1;
+    }
+  }
+#else /* NBR_TABLE_WITH_HASH */
   key = list_head(nbr_table_keys);
   while(key != NULL) {
     if(lladdr && linkaddr_cmp(lladdr, &key->lladdr)) {
@@ -143,9 +239,85 @@ index_from_lladdr(const linkaddr_t *lladdr)
     }
     key = list_item_next(key);
   }
+#endif /* NBR_TABLE_WITH_HASH */
   return -1;
 }
 /*---------------------------------------------------------------------------*/
+#if NBR_TABLE_LRU_EVICTION
+static void
+bucket_remove(nbr_table_key_t *key)
+{
+  if(key->bucket == NO_BUCKET) {
+    return;
+  }
+  if(key->lru_prev != NULL) {
+    key->lru_prev->lru_next = key->lru_next;
+  } else {
+    bucket_head[key->bucket] = key->lru_next;
+  }
+  if(key->lru_next != NULL) {
+    key->lru_next->lru_prev = key->lru_prev;
+  } else {
+    bucket_tail[key->bucket] = key->lru_prev;
+  }
+  key->bucket = NO_BUCKET;
+}
+/*---------------------------------------------------------------------------*/
+/* Move a neighbor to the bucket that matches its used and locked maps */
+static void
+bucket_update(int index)
+{
+  nbr_table_key_t *key = key_from_index(index);
+  nbr_table_key_t *prev;
+  clock_time_t now, age;
+  uint8_t used;
+  uint8_t bucket;
+
+  if(locked_map[index]) {
+    bucket = NO_BUCKET;
+  } else {
+    /* Count how many tables are using this item */
+    bucket = 0;
+    for(used = used_map[index]; used != 0; used >>= 1) {
+      bucket += used & 1;
+    }
+  }
+
+  if(bucket == key->bucket) {
+    return;
+  }
+  bucket_remove(key);
+  if(bucket == NO_BUCKET) {
+    return;
+  }
+
+  /* Insert by last seen time, walking from the tail of the bucket.
+   * Touched neighbors stop the walk right away, as do those seen more
+   * recently than the others. A neighbor not seen in a while costs a
+   * walk of up to the whole bucket. */
+  now = clock_time();
+  age = now - key->last_seen;
+  prev = bucket_tail[bucket];
+  while(prev != NULL && (clock_time_t)(now - prev->last_seen) < age) {
+    prev = prev->lru_prev;
+  }
+  key->lru_prev = prev;
+  if(prev != NULL) {
+    key->lru_next = prev->lru_next;
+    prev->lru_next = key;
+  } else {
+    key->lru_next = bucket_head[bucket];
+    bucket_head[bucket] = key;
+  }
+  if(key->lru_next != NULL) {
+    key->lru_next->lru_prev = key;
+  } else {
+    bucket_tail[bucket] = key;
+  }
+  key->bucket = bucket;
+}
+#endif /* NBR_TABLE_LRU_EVICTION */
+/*---------------------------------------------------------------------------*/
 /* Get bit from "used" or "locked" bitmap */
 static int
 nbr_get_bit(uint8_t *bitmap, nbr_table_t *table, nbr_table_item_t *item)
@@ -171,6 +343,9 @@ nbr_set_bit(uint8_t *bitmap, nbr_table_t *table, nbr_table_item_t *item, int val
     } else {
       bitmap[item_index] &= ~(1 << table->index);
     }
+#if NBR_TABLE_LRU_EVICTION
+    bucket_update(item_index);
+#endif /* NBR_TABLE_LRU_EVICTION */
     return 1;
   } else {
     return 0;
@@ -193,19 +368,36 @@ remove_key(nbr_table_key_t *least_used_key)
   }
   /* Empty used map */
   used_map[index_from_key(least_used_key)] = 0;
+#if NBR_TABLE_LRU_EVICTION
+  /* The key is reused right away, so it keeps its place in the list,
+   * which is not used for eviction */
+  bucket_remove(least_used_key);
+#else /* NBR_TABLE_LRU_EVICTION */
   /* Remove neighbor from list */
   list_remove(nbr_table_keys, least_used_key);
+#endif /* NBR_TABLE_LRU_EVICTION */
+#if NBR_TABLE_WITH_HASH
+  hash_remove(least_used_key);
+#endif /* NBR_TABLE_WITH_HASH */
 }
 /*---------------------------------------------------------------------------*/
 static nbr_table_key_t *
 nbr_table_allocate(nbr_table_reason_t reason, void *data)
 {
   nbr_table_key_t *key;
-  int least_used_count = 0;
   nbr_table_key_t *least_used_key = NULL;
+#if NBR_TABLE_LRU_EVICTION
+  int i;
+#else /* NBR_TABLE_LRU_EVICTION */
+  int least_used_count = 0;
+#endif /* NBR_TABLE_LRU_EVICTION */
 
   key = memb_alloc(&neighbor_addr_mem);
   if(key != NULL) {
+#if NBR_TABLE_LRU_EVICTION
+    /* Add neighbor to list */
+    list_add(nbr_table_keys, key);
+#endif /* NBR_TABLE_LRU_EVICTION */
     return key;
   } else {
 #ifdef NBR_TABLE_FIND_REMOVABLE
@@ -231,6 +423,13 @@ nbr_table_allocate(nbr_table_reason_t reason, void *data)
     }
 #endif /* NBR_TABLE_FIND_REMOVABLE */
 
+#if NBR_TABLE_LRU_EVICTION
+    /* No more space, free the least recently seen neighbor among the
+     * unlocked ones used by the fewest tables */
+    for(i = 0; i <= MAX_NUM_TABLES && least_used_key == NULL; i++) {
+      least_used_key = bucket_head[i];
+    }
+#else /* NBR_TABLE_LRU_EVICTION */
     if(least_used_key == NULL) {
       /* No more space, try to free a neighbor.
        * The replacement policy is the following: remove neighbor that is:
@@ -266,6 +465,7 @@ nbr_table_allocate(nbr_table_reason_t reason, void *data)
         key = list_item_next(key);
       }
     }
+#endif /* NBR_TABLE_LRU_EVICTION */
 
     if(least_used_key == NULL) {
       /* We haven't found any unlocked item, allocation fails */
@@ -369,14 +569,24 @@ nbr_table_add_lladdr(nbr_table_t *table, const linkaddr_t *lladdr, nbr_table_rea
       return NULL;
     }
 
+#if !NBR_TABLE_LRU_EVICTION
     /* Add neighbor to list */
     list_add(nbr_table_keys, key);
+#endif /* !NBR_TABLE_LRU_EVICTION */
 
     /* Get index from newly allocated neighbor */
     index = index_from_key(key);
 
     /* Set link-layer address */
     linkaddr_copy(&key->lladdr, lladdr);
+#if NBR_TABLE_LRU_EVICTION
+    /* The neighbor joins a bucket when its used bit is set below */
+    key->bucket = NO_BUCKET;
+    key->last_seen = clock_time();
+#endif /* NBR_TABLE_LRU_EVICTION */
+#if NBR_TABLE_WITH_HASH
+    hash_add(key);
+#endif /* NBR_TABLE_WITH_HASH */
   }
 
   /* Get item in the current table */
@@ -439,6 +649,34 @@ nbr_table_get_lladdr(nbr_table_t *table, const void *item)
   return key != NULL ? &key->lladdr : NULL;
 }
 /*---------------------------------------------------------------------------*/
+/* Record that a neighbor was just seen */
+void
+nbr_table_touch(nbr_table_t *table, const nbr_table_item_t *item)
+{
+#if NBR_TABLE_LRU_EVICTION
+  int index = index_from_item(table, item);
+  nbr_table_key_t *key;
+
+  if(index != -1) {
+    key = key_from_index(index);
+    key->last_seen = clock_time();
+    /* Move the neighbor to the tail of its bucket */
+    bucket_remove(key);
+    bucket_update(index);
+  }
+#endif /* NBR_TABLE_LRU_EVICTION */
+}
+/*---------------------------------------------------------------------------*/
+#if NBR_TABLE_LRU_EVICTION
+/* Get the time a neighbor was last seen */
+clock_time_t
+nbr_table_get_last_seen(nbr_table_t *table, const void *item)
+{
+  nbr_table_key_t *key = key_from_item(table, item);
+  return key != NULL ? key->last_seen : 0;
+}
+#endif /* NBR_TABLE_LRU_EVICTION */
+/*---------------------------------------------------------------------------*/
 #if DEBUG
 static void
 print_table()
@@ -46,6 +46,38 @@
 #define NBR_TABLE_MAX_NEIGHBORS 8
 #endif /* NBR_TABLE_CONF_MAX_NEIGHBORS */
 
+/* Index the neighbors by link-layer address in a hash table, so that
+ * looking up a neighbor does not walk the list of all neighbors.
+ * Useful with large tables, e.g. on border routers. */
+#ifdef NBR_TABLE_CONF_WITH_HASH
+#define NBR_TABLE_WITH_HASH NBR_TABLE_CONF_WITH_HASH
+#else /* NBR_TABLE_CONF_WITH_HASH */
+#define NBR_TABLE_WITH_HASH 0
+#endif /* NBR_TABLE_CONF_WITH_HASH */
+
+/* Keep the unlocked neighbors in buckets by number of tables using
+ * them, each ordered by the time the neighbor was last seen (see
+ * nbr_table_touch()). When the table is full, the least recently seen
+ * neighbor of the lowest bucket is evicted in constant time. Touching
+ * a neighbor takes constant time too. A neighbor whose number of
+ * tables changes is inserted in its new bucket by last seen time,
+ * which takes up to the size of that bucket. Without this, the table
+ * is scanned and the oldest inserted neighbor among the least used
+ * ones is evicted. */
+#ifdef NBR_TABLE_CONF_LRU_EVICTION
+#define NBR_TABLE_LRU_EVICTION NBR_TABLE_CONF_LRU_EVICTION
+#else /* NBR_TABLE_CONF_LRU_EVICTION */
+#define NBR_TABLE_LRU_EVICTION 0
+#endif /* NBR_TABLE_CONF_LRU_EVICTION */
+
+/* Number of slots in the hash index. Must be larger than the number
+ * of neighbors; lookups slow down as the index fills up. */
+#ifdef NBR_TABLE_CONF_HASH_SIZE
+#define NBR_TABLE_HASH_SIZE NBR_TABLE_CONF_HASH_SIZE
+#else /* NBR_TABLE_CONF_HASH_SIZE */
+#define NBR_TABLE_HASH_SIZE (2 * NBR_TABLE_MAX_NEIGHBORS)
+#endif /* NBR_TABLE_CONF_HASH_SIZE */
+
 /* An item in a neighbor table */
 typedef void nbr_table_item_t;
 
@@ -115,4 +147,14 @@ int nbr_table_unlock(nbr_table_t *table, nbr_table_item_t *item);
 linkaddr_t *nbr_table_get_lladdr(nbr_table_t *table, const nbr_table_item_t *item);
 /** @} */
 
+/** \name Neighbor tables: eviction */
+/** @{ */
+/* Record that the neighbor of an item was just seen, e.g. that a frame
+ * was received from it. Only has an effect with NBR_TABLE_LRU_EVICTION. */
+void nbr_table_touch(nbr_table_t *table, const nbr_table_item_t *item);
+#if NBR_TABLE_LRU_EVICTION
+clock_time_t nbr_table_get_last_seen(nbr_table_t *table, const nbr_table_item_t *item);
+#endif /* NBR_TABLE_LRU_EVICTION */
+/** @} */
+
 #endif /* NBR_TABLE_H_ */
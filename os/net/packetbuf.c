@@ -47,20 +47,44 @@
 #include "contiki-net.h"
 #include "net/packetbuf.h"
 #include "sys/cc.h"
+#include "lib/memb.h"
 
-struct packetbuf_attr packetbuf_attrs[PACKETBUF_NUM_ATTRS];
-struct packetbuf_addr packetbuf_addrs[PACKETBUF_NUM_ADDRS];
+/* The number of words of the dirty attribute bitmap */
+#define DIRTY_WORDS ((PACKETBUF_ATTR_MAX + 31) / 32)
 
+/* A packet descriptor: the packet buffer and its state */
+struct packetbuf {
+  /* The declaration below ensures that the packet buffer is aligned
+     on an even 32-bit boundary. On some platforms (most notably the
+     msp430 or OpenRISC), having a potentially misaligned packet buffer
+     may lead to problems when accessing words. */
+  uint32_t aligned[(PACKETBUF_HEADROOM + PACKETBUF_SIZE + 3) / 4];
+  /* The start of the packet: in the aligned buffer above, after the
+     headroom that prepended headers did not use, or in an adopted
+     buffer */
+  uint8_t *buf;
+  /* Called to release the external buffer adopted with
+     packetbuf_adopt(), or NULL if the descriptor uses its own buffer */
+  void (*release_adopted)(void *buf);
+  uint16_t buflen, bufptr;
+  uint8_t hdrlen;
+  /* One bit per attribute or address type that may be non-zero, so
+     that clearing only touches those */
+  uint32_t dirty[DIRTY_WORDS];
+  struct packetbuf_attr attrs[PACKETBUF_NUM_ATTRS];
+  struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
+};
 
-static uint16_t buflen, bufptr;
-static uint8_t hdrlen;
+/* The descriptor used by default, which is never freed */
+static struct packetbuf main_packetbuf = {
+  .buf = (uint8_t *)main_packetbuf.aligned + PACKETBUF_HEADROOM
+};
+#if PACKETBUF_NUM > 1
+MEMB(packetbuf_mem, struct packetbuf, PACKETBUF_NUM - 1);
+#endif /* PACKETBUF_NUM > 1 */
 
-/* The declarations below ensure that the packet buffer is aligned on
-   an even 32-bit boundary. On some platforms (most notably the
-   msp430 or OpenRISC), having a potentially misaligned packet buffer may lead to
-   problems when accessing words. */
-static uint32_t packetbuf_aligned[(PACKETBUF_SIZE + 3) / 4];
-static uint8_t *packetbuf = (uint8_t *)packetbuf_aligned;
+/* The descriptor all packetbuf functions operate on */
+static struct packetbuf *current = &main_packetbuf;
 
 #define DEBUG 0
 #if DEBUG
@@ -70,14 +94,153 @@ static uint8_t *packetbuf = (uint8_t *)packetbuf_aligned;
 #define PRINTF(...)
 #endif
 
+#define BUF_START(p) ((uint8_t *)(p)->aligned + PACKETBUF_HEADROOM)
+#define MARK_DIRTY(p, type) ((p)->dirty[(type) / 32] |= (uint32_t)1 << ((type) % 32))
+
+/*---------------------------------------------------------------------------*/
+/* Marks buffers adopted without a release function */
+static void
+release_nothing(void *buf)
+{
+}
+/*---------------------------------------------------------------------------*/
+/* Go back to the descriptor's own buffer */
+static void
+release_buffer(struct packetbuf *p)
+{
+  void (*release)(void *buf) = p->release_adopted;
+  void *buf = p->buf;
+
+  if(release != NULL) {
+    p->release_adopted = NULL;
+    p->buf = BUF_START(p);
+    release(buf);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+lowest_bit(uint32_t x)
+{
+#ifdef __GNUC__
+  return __builtin_ctzl(x);
+#else /* __GNUC__ */
+  int i;
+
+  for(i = 0; !(x & 1); i++, x >>= 1);
+  return i;
+#endif /* __GNUC__ */
+}
+/*---------------------------------------------------------------------------*/
+/* Zero the attributes and addresses that were set since the last clear */
+static void
+clear_attrs(struct packetbuf *p)
+{
+  uint32_t dirty;
+  int w, type;
+
+  for(w = 0; w < DIRTY_WORDS; w++) {
+    dirty = p->dirty[w];
+    p->dirty[w] = 0;
+    while(dirty != 0) {
+      type = w * 32 + lowest_bit(dirty);
+      dirty &= dirty - 1;
+      if(type >= PACKETBUF_ATTR_MAX) {
+        break;
+      }
+      if(PACKETBUF_IS_ADDR(type)) {
+        memset(&p->addrs[type - PACKETBUF_ADDR_FIRST].addr, 0,
+               sizeof(linkaddr_t));
+      } else {
+        p->attrs[type].val = 0;
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+clear(struct packetbuf *p)
+{
+  release_buffer(p);
+  p->buf = BUF_START(p);
+  p->buflen = p->bufptr = 0;
+  p->hdrlen = 0;
+  clear_attrs(p);
+}
+/*---------------------------------------------------------------------------*/
+struct packetbuf *
+packetbuf_alloc(void)
+{
+#if PACKETBUF_NUM > 1
+  struct packetbuf *p = memb_alloc(&packetbuf_mem);
+
+  if(p != NULL) {
+    p->release_adopted = NULL;
+    clear(p);
+  }
+  return p;
+#else /* PACKETBUF_NUM > 1 */
+  return NULL;
+#endif /* PACKETBUF_NUM > 1 */
+}
 /*---------------------------------------------------------------------------*/
 void
-packetbuf_clear(void)
+packetbuf_free(struct packetbuf *p)
 {
-  buflen = bufptr = 0;
-  hdrlen = 0;
+#if PACKETBUF_NUM > 1
+  if(p == NULL || p == &main_packetbuf) {
+    return;
+  }
+  if(current == p) {
+    current = &main_packetbuf;
+  }
+  release_buffer(p);
+  memb_free(&packetbuf_mem, p);
+#endif /* PACKETBUF_NUM > 1 */
+}
+/*---------------------------------------------------------------------------*/
+struct packetbuf *
+packetbuf_select(struct packetbuf *p)
+{
+  struct packetbuf *previous = current;
 
-  packetbuf_attr_clear();
+  current = p != NULL ? p : &main_packetbuf;
+  return previous;
+}
+/*---------------------------------------------------------------------------*/
+struct packetbuf *
+packetbuf_current(void)
+{
+  return current;
+}
+/*---------------------------------------------------------------------------*/
+void
+packetbuf_copyfrom_packetbuf(const struct packetbuf *from)
+{
+  struct packetbuf *p = current;
+
+  if(from == p) {
+    return;
+  }
+  release_buffer(p);
+  /* Leave as much headroom as the original packet has */
+  if(from->release_adopted == NULL) {
+    p->buf = (uint8_t *)p->aligned + (from->buf - (uint8_t *)from->aligned);
+  } else {
+    p->buf = BUF_START(p);
+  }
+  p->bufptr = from->bufptr;
+  p->hdrlen = from->hdrlen;
+  p->buflen = from->buflen;
+  memcpy(p->buf, from->buf, from->bufptr + from->hdrlen + from->buflen);
+  memcpy(p->attrs, from->attrs, sizeof(p->attrs));
+  memcpy(p->addrs, from->addrs, sizeof(p->addrs));
+  memcpy(p->dirty, from->dirty, sizeof(p->dirty));
+}
+/*---------------------------------------------------------------------------*/
+void
+packetbuf_clear(void)
+{
+  clear(current);
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -87,48 +250,74 @@ packetbuf_copyfrom(const void *from, uint16_t len)
 
   packetbuf_clear();
   l = MIN(PACKETBUF_SIZE, len);
-  memcpy(packetbuf, from, l);
-  buflen = l;
+  memcpy(current->buf, from, l);
+  current->buflen = l;
   return l;
 }
 /*---------------------------------------------------------------------------*/
 int
 packetbuf_copyto(void *to)
 {
-  if(hdrlen + buflen > PACKETBUF_SIZE) {
+  if(current->hdrlen + current->buflen > PACKETBUF_SIZE) {
     return 0;
   }
-  memcpy(to, packetbuf_hdrptr(), hdrlen);
-  memcpy((uint8_t *)to + hdrlen, packetbuf_dataptr(), buflen);
-  return hdrlen + buflen;
+  memcpy(to, packetbuf_hdrptr(), current->hdrlen);
+  /* The data may already be in place, if packetbuf adopted the buffer */
+  memmove((uint8_t *)to + current->hdrlen, packetbuf_dataptr(),
+          current->buflen);
+  return current->hdrlen + current->buflen;
+}
+/*---------------------------------------------------------------------------*/
+void
+packetbuf_adopt(void *buf, uint16_t len, void (*release)(void *buf))
+{
+  packetbuf_clear();
+  current->buf = buf;
+  current->buflen = MIN(PACKETBUF_SIZE, len);
+  current->release_adopted = release != NULL ? release : release_nothing;
 }
 /*---------------------------------------------------------------------------*/
 int
 packetbuf_hdralloc(int size)
 {
-  int16_t i;
+  struct packetbuf *p = current;
+  uint8_t *start;
+  int headroom;
 
   if(size + packetbuf_totlen() > PACKETBUF_SIZE) {
     return 0;
   }
 
-  /* shift data to the right */
-  for(i = packetbuf_totlen() - 1; i >= 0; i--) {
-    packetbuf[i + size] = packetbuf[i];
+  if(p->release_adopted != NULL) {
+    /* Copy the adopted packet to our own buffer, right of the header,
+       instead of modifying it */
+    start = size <= PACKETBUF_HEADROOM ?
+      BUF_START(p) - size : (uint8_t *)p->aligned;
+    memcpy(start + size, p->buf, packetbuf_totlen());
+    release_buffer(p);
+    p->buf = start;
+  } else {
+    headroom = p->buf - (uint8_t *)p->aligned;
+    if(headroom < size) {
+      /* Not enough headroom: shift data to the right */
+      memmove(p->buf + size - headroom, p->buf, packetbuf_totlen());
+      p->buf += size - headroom;
+    }
+    p->buf -= size;
   }
-  hdrlen += size;
+  p->hdrlen += size;
   return 1;
 }
 /*---------------------------------------------------------------------------*/
 int
 packetbuf_hdrreduce(int size)
 {
-  if(buflen < size) {
+  if(current->buflen < size) {
     return 0;
   }
 
-  bufptr += size;
-  buflen -= size;
+  current->bufptr += size;
+  current->buflen -= size;
   return 1;
 }
 /*---------------------------------------------------------------------------*/
@@ -136,31 +325,31 @@ void
 packetbuf_set_datalen(uint16_t len)
 {
   PRINTF("packetbuf_set_len: len %d\n", len);
-  buflen = len;
+  current->buflen = len;
 }
 /*---------------------------------------------------------------------------*/
 void *
 packetbuf_dataptr(void)
 {
-  return packetbuf + packetbuf_hdrlen();
+  return current->buf + packetbuf_hdrlen();
 }
 /*---------------------------------------------------------------------------*/
 void *
 packetbuf_hdrptr(void)
 {
-  return packetbuf;
+  return current->buf;
 }
 /*---------------------------------------------------------------------------*/
 uint16_t
 packetbuf_datalen(void)
 {
-  return buflen;
+  return current->buflen;
 }
 /*---------------------------------------------------------------------------*/
 uint8_t
 packetbuf_hdrlen(void)
 {
-  return bufptr + hdrlen;
+  return current->bufptr + current->hdrlen;
 }
 /*---------------------------------------------------------------------------*/
 uint16_t
@@ -178,59 +367,58 @@ packetbuf_remaininglen(void)
 void
 packetbuf_attr_clear(void)
 {
-  int i;
-  memset(packetbuf_attrs, 0, sizeof(packetbuf_attrs));
-  for(i = 0; i < PACKETBUF_NUM_ADDRS; ++i) {
-    linkaddr_copy(&packetbuf_addrs[i].addr, &linkaddr_null);
-  }
+  clear_attrs(current);
 }
 /*---------------------------------------------------------------------------*/
 void
 packetbuf_attr_copyto(struct packetbuf_attr *attrs,
                       struct packetbuf_addr *addrs)
 {
-  memcpy(attrs, packetbuf_attrs, sizeof(packetbuf_attrs));
-  memcpy(addrs, packetbuf_addrs, sizeof(packetbuf_addrs));
+  memcpy(attrs, current->attrs, sizeof(current->attrs));
+  memcpy(addrs, current->addrs, sizeof(current->addrs));
 }
 /*---------------------------------------------------------------------------*/
 void
 packetbuf_attr_copyfrom(struct packetbuf_attr *attrs,
                         struct packetbuf_addr *addrs)
 {
-  memcpy(packetbuf_attrs, attrs, sizeof(packetbuf_attrs));
-  memcpy(packetbuf_addrs, addrs, sizeof(packetbuf_addrs));
+  memcpy(current->attrs, attrs, sizeof(current->attrs));
+  memcpy(current->addrs, addrs, sizeof(current->addrs));
+  memset(current->dirty, 0xff, sizeof(current->dirty));
 }
 /*---------------------------------------------------------------------------*/
 int
 packetbuf_set_attr(uint8_t type, const packetbuf_attr_t val)
 {
-  packetbuf_attrs[type].val = val;
+  current->attrs[type].val = val;
+  MARK_DIRTY(current, type);
   return 1;
 }
 /*---------------------------------------------------------------------------*/
 packetbuf_attr_t
 packetbuf_attr(uint8_t type)
 {
-  return packetbuf_attrs[type].val;
+  return current->attrs[type].val;
 }
 /*---------------------------------------------------------------------------*/
 int
 packetbuf_set_addr(uint8_t type, const linkaddr_t *addr)
 {
-  linkaddr_copy(&packetbuf_addrs[type - PACKETBUF_ADDR_FIRST].addr, addr);
+  linkaddr_copy(&current->addrs[type - PACKETBUF_ADDR_FIRST].addr, addr);
+  MARK_DIRTY(current, type);
   return 1;
 }
 /*---------------------------------------------------------------------------*/
 const linkaddr_t *
 packetbuf_addr(uint8_t type)
 {
-  return &packetbuf_addrs[type - PACKETBUF_ADDR_FIRST].addr;
+  return &current->addrs[type - PACKETBUF_ADDR_FIRST].addr;
 }
 /*---------------------------------------------------------------------------*/
 int
 packetbuf_holds_broadcast(void)
 {
-  return linkaddr_cmp(&packetbuf_addrs[PACKETBUF_ADDR_RECEIVER - PACKETBUF_ADDR_FIRST].addr, &linkaddr_null);
+  return linkaddr_cmp(&current->addrs[PACKETBUF_ADDR_RECEIVER - PACKETBUF_ADDR_FIRST].addr, &linkaddr_null);
 }
 /*---------------------------------------------------------------------------*/
 
@@ -66,6 +66,47 @@
 #define PACKETBUF_SIZE 128
 #endif
 
+/**
+ * \brief      The number of packet descriptors
+ *
+ *             Each descriptor holds a packet buffer with its header
+ *             and attributes. All packetbuf functions operate on the
+ *             current descriptor, which can be switched with
+ *             packetbuf_select(), e.g. to receive a frame or to build
+ *             a fragment without disturbing the packet being
+ *             prepared. The first descriptor is always available;
+ *             the others are allocated with packetbuf_alloc().
+ */
+#ifdef PACKETBUF_CONF_NUM
+#define PACKETBUF_NUM PACKETBUF_CONF_NUM
+#else
+#define PACKETBUF_NUM 1
+#endif
+
+/**
+ * \brief      The headroom reserved in front of the packet, in bytes
+ *
+ *             Outbound packets are built from the start of the data,
+ *             and headers are then prepended with
+ *             packetbuf_hdralloc(). Headers that fit in the headroom
+ *             are prepended in place; larger ones require shifting
+ *             the whole packet. A headroom as large as the link-layer
+ *             header (e.g. 32 bytes for 802.15.4 with security) thus
+ *             saves a copy of every frame sent, at the cost of as
+ *             much RAM per descriptor. The headroom is rounded up to
+ *             a multiple of 4, so that the data stays word-aligned.
+ */
+#ifdef PACKETBUF_CONF_HEADROOM
+#define PACKETBUF_HEADROOM ((PACKETBUF_CONF_HEADROOM + 3) & ~3)
+#else
+#define PACKETBUF_HEADROOM 0
+#endif
+
+/**
+ * \brief      A packet descriptor, only accessed through packetbuf functions
+ */
+struct packetbuf;
+
 /**
  * \brief      Clear and reset the packetbuf
  *
@@ -191,6 +232,79 @@ int packetbuf_hdralloc(int size);
  */
 int packetbuf_hdrreduce(int size);
 
+/**
+ * \brief      Use an external buffer as packetbuf, instead of copying it
+ * \param buf  The buffer, of PACKETBUF_SIZE bytes, aligned on 32 bits
+ * \param len  The length of the packet in the buffer
+ * \param release A function called with buf when packetbuf stops using
+ *             it, or NULL
+ *
+ *             This function clears the packetbuf and makes it use the
+ *             packet in buf, which is not copied. The buffer is used
+ *             until the packetbuf is cleared (e.g. by
+ *             packetbuf_copyfrom()), another buffer is adopted, or a
+ *             header is allocated with packetbuf_hdralloc(). In the
+ *             latter case, the packet is first copied back to the
+ *             packetbuf's own buffer, so that buf is never modified
+ *             by packetbuf functions.
+ *
+ *             Pointers to the packetbuf's data must not be kept across
+ *             calls to this function.
+ *
+ */
+void packetbuf_adopt(void *buf, uint16_t len, void (*release)(void *buf));
+
+/**
+ * \brief      Allocate a packet descriptor
+ * \return     A cleared descriptor, or NULL if none is available
+ *
+ *             The descriptor is not made current: use
+ *             packetbuf_select() to operate on it. Only
+ *             PACKETBUF_NUM - 1 descriptors can be allocated.
+ */
+struct packetbuf *packetbuf_alloc(void);
+
+/**
+ * \brief      Free a packet descriptor allocated with packetbuf_alloc()
+ * \param p    The descriptor
+ *
+ *             If the descriptor is the current one, the first
+ *             descriptor becomes current again.
+ */
+void packetbuf_free(struct packetbuf *p);
+
+/**
+ * \brief      Make a packet descriptor current
+ * \param p    The descriptor, or NULL for the first descriptor
+ * \return     The previously current descriptor
+ *
+ *             All packetbuf functions operate on the current
+ *             descriptor. The previous one is left untouched, and can
+ *             be selected again with the returned value:
+ *
+ *             \code
+ *             prev = packetbuf_select(rx);
+ *             packetbuf_copyfrom(frame, len);
+ *             NETSTACK_MAC.input();
+ *             packetbuf_select(prev);
+ *             \endcode
+ */
+struct packetbuf *packetbuf_select(struct packetbuf *p);
+
+/**
+ * \brief      Get the current packet descriptor
+ * \return     The current descriptor
+ */
+struct packetbuf *packetbuf_current(void);
+
+/**
+ * \brief      Copy another packet descriptor into the current one
+ * \param from The descriptor to copy
+ *
+ *             The header, the data and the attributes are copied.
+ */
+void packetbuf_copyfrom_packetbuf(const struct packetbuf *from);
+
 /* Packet attributes stuff below: */
 
 typedef uint16_t packetbuf_attr_t;
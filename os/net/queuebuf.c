@@ -73,14 +73,31 @@ struct queuebuf {
 
 /* The actual queuebuf data */
 struct queuebuf_data {
+#if QUEUEBUF_ZERO_COPY
+  /* The data is first, and aligned like packetbuf, so that packetbuf
+     can adopt it */
+  union {
+    uint8_t data[PACKETBUF_SIZE];
+    uint32_t data_aligned[(PACKETBUF_SIZE + 3) / 4];
+  };
+  /* The number of queuebufs and packetbufs using the data */
+  uint8_t refs;
+#else /* QUEUEBUF_ZERO_COPY */
   uint8_t data[PACKETBUF_SIZE];
+#endif /* QUEUEBUF_ZERO_COPY */
   uint16_t len;
   struct packetbuf_attr attrs[PACKETBUF_NUM_ATTRS];
   struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
 };
 
 MEMB(bufmem, struct queuebuf, QUEUEBUF_NUM);
+#if QUEUEBUF_ZERO_COPY
+/* One more per packet descriptor, for the data it may keep adopted after
+   its queuebuf is freed */
+MEMB(buframmem, struct queuebuf_data, QUEUEBUFRAM_NUM + PACKETBUF_NUM);
+#else /* QUEUEBUF_ZERO_COPY */
 MEMB(buframmem, struct queuebuf_data, QUEUEBUFRAM_NUM);
+#endif /* QUEUEBUF_ZERO_COPY */
 
 #if WITH_SWAP
 
@@ -135,6 +152,14 @@ LIST(queuebuf_list);
 uint8_t queuebuf_len, queuebuf_max_len;
 #endif /* QUEUEBUF_STATS */
 
+#if MEMB_STATS
+/* Charge a failed allocation to whoever asked for the queuebuf,
+   rather than to this module */
+#define BLAME_CALLER(pool) (pool)->failure_caller = CC_RETURN_ADDRESS()
+#else /* MEMB_STATS */
+#define BLAME_CALLER(pool)
+#endif /* MEMB_STATS */
+
 #if WITH_SWAP
 /*---------------------------------------------------------------------------*/
 static void
@@ -276,6 +301,20 @@ queuebuf_load_to_ram(struct queuebuf *b)
   return b->ram_ptr;
 }
 #endif /* WITH_SWAP */
+#if QUEUEBUF_ZERO_COPY
+/*---------------------------------------------------------------------------*/
+/* Drop a reference to queuebuf data, and free it if it was the last one.
+   The data array is the first member of struct queuebuf_data. */
+static void
+release_data(void *ptr)
+{
+  struct queuebuf_data *buframptr = ptr;
+
+  if(--buframptr->refs == 0) {
+    memb_free(&buframmem, buframptr);
+  }
+}
+#endif /* QUEUEBUF_ZERO_COPY */
 /*---------------------------------------------------------------------------*/
 void
 queuebuf_init(void)
@@ -334,6 +373,7 @@ queuebuf_new_from_packetbuf(void)
 #else
     if(buf->ram_ptr == NULL) {
       PRINTF("queuebuf_new_from_packetbuf: could not queuebuf data\n");
+      BLAME_CALLER(&buframmem);
       memb_free(&bufmem, buf);
       return NULL;
     }
@@ -342,6 +382,9 @@ queuebuf_new_from_packetbuf(void)
 
     buframptr->len = packetbuf_copyto(buframptr->data);
     packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
+#if QUEUEBUF_ZERO_COPY
+    buframptr->refs = 1;
+#endif /* QUEUEBUF_ZERO_COPY */
 
 #if WITH_SWAP
     if(buf->location == IN_CFS) {
@@ -363,6 +406,7 @@ queuebuf_new_from_packetbuf(void)
 
   } else {
     PRINTF("queuebuf_new_from_packetbuf: could not allocate a queuebuf\n");
+    BLAME_CALLER(&bufmem);
   }
   return buf;
 }
@@ -402,6 +446,8 @@ queuebuf_free(struct queuebuf *buf)
     } else {
       queuebuf_remove_from_file(buf->swap_id);
     }
+#elif QUEUEBUF_ZERO_COPY
+    release_data(buf->ram_ptr);
 #else
     memb_free(&buframmem, buf->ram_ptr);
 #endif
@@ -421,7 +467,13 @@ queuebuf_to_packetbuf(struct queuebuf *b)
 {
   if(memb_inmemb(&bufmem, b)) {
     struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+#if QUEUEBUF_ZERO_COPY
+    /* Let packetbuf use the data in place, with a reference of its own */
+    buframptr->refs++;
+    packetbuf_adopt(buframptr->data, buframptr->len, release_data);
+#else /* QUEUEBUF_ZERO_COPY */
     packetbuf_copyfrom(buframptr->data, buframptr->len);
+#endif /* QUEUEBUF_ZERO_COPY */
     packetbuf_attr_copyfrom(buframptr->attrs, buframptr->addrs);
   }
 }
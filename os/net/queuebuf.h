@@ -79,6 +79,22 @@
   #define WITH_SWAP 0
 #endif /* QUEUEBUFRAM_CONF_NUM */
 
+/* With QUEUEBUF_CONF_ZERO_COPY, queuebuf_to_packetbuf() does not copy
+   the queued packet: packetbuf adopts the storage of the queuebuf, which
+   is reference counted, until packetbuf is cleared or a header is
+   allocated in it. This saves a copy of each packet every time it is
+   transmitted, and when it is handed back to the upper layers after
+   transmission. Cannot be used together with swapping. */
+#ifdef QUEUEBUF_CONF_ZERO_COPY
+#define QUEUEBUF_ZERO_COPY QUEUEBUF_CONF_ZERO_COPY
+#else /* QUEUEBUF_CONF_ZERO_COPY */
+#define QUEUEBUF_ZERO_COPY 0
+#endif /* QUEUEBUF_CONF_ZERO_COPY */
+
+#if QUEUEBUF_ZERO_COPY && WITH_SWAP
+#error "QUEUEBUF_CONF_ZERO_COPY cannot be used with QUEUEBUFRAM_CONF_NUM < QUEUEBUF_NUM"
+#endif /* QUEUEBUF_ZERO_COPY && WITH_SWAP */
+
 #ifdef QUEUEBUF_CONF_DEBUG
 #define QUEUEBUF_DEBUG QUEUEBUF_CONF_DEBUG
 #else /* QUEUEBUF_CONF_DEBUG */
@@ -332,6 +332,49 @@ count_matching_bytes(const void *p1, const void *p2, size_t n)
   return n;
 }
 /*---------------------------------------------------------------------------*/
+#if UIP_SR_SRH_CACHE_SIZE
+/* Inserts a source routing header cached by the root for the destination
+ * of the packet, saving the walk of the source routing graph. Returns 1 on
+ * success, 0 on failure. */
+static int
+insert_cached_srh_header(const uip_sr_srh_t *srh)
+{
+  uint8_t temp_len;
+
+  LOG_DBG("SRH using cached header for ");
+  LOG_DBG_6ADDR(&UIP_IP_BUF->destipaddr);
+  LOG_DBG_(", ext len %u\n", srh->len);
+
+  /* Check if there is enough space to store the extension header */
+  if(uip_len + srh->len > UIP_BUFSIZE - UIP_LLH_LEN) {
+    LOG_ERR("Packet too long: impossible to add source routing header (%u bytes)\n", srh->len);
+    return 0;
+  }
+
+  /* Move existing ext headers and payload uip_ext_len further */
+  memmove(uip_buf + uip_l2_l3_hdr_len + srh->len,
+      uip_buf + uip_l2_l3_hdr_len, uip_len - UIP_IPH_LEN);
+  memcpy(uip_buf + uip_l2_l3_hdr_len, srh->hdr, srh->len);
+
+  /* Only the next header field differs between packets */
+  UIP_RH_BUF->next = UIP_IP_BUF->proto;
+  UIP_IP_BUF->proto = UIP_PROTO_ROUTING;
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &srh->first_hop);
+
+  /* In-place update of IPv6 length field */
+  temp_len = UIP_IP_BUF->len[1];
+  UIP_IP_BUF->len[1] += srh->len;
+  if(UIP_IP_BUF->len[1] < temp_len) {
+    UIP_IP_BUF->len[0]++;
+  }
+
+  uip_ext_len += srh->len;
+  uip_len += srh->len;
+
+  return 1;
+}
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+/*---------------------------------------------------------------------------*/
 static int
 insert_srh_header(void)
 {
@@ -347,6 +390,9 @@ insert_srh_header(void)
   uip_sr_node_t *node;
   rpl_dag_t *dag;
   uip_ipaddr_t node_addr;
+#if UIP_SR_SRH_CACHE_SIZE
+  const uip_sr_srh_t *srh;
+#endif /* UIP_SR_SRH_CACHE_SIZE */
 
   LOG_INFO("SRH creating source routing header with destination ");
   LOG_INFO_6ADDR(&UIP_IP_BUF->destipaddr);
@@ -362,6 +408,13 @@ insert_srh_header(void)
     return 0;
   }
 
+#if UIP_SR_SRH_CACHE_SIZE
+  srh = uip_sr_srh_lookup(dag, &UIP_IP_BUF->destipaddr);
+  if(srh != NULL) {
+    return insert_cached_srh_header(srh);
+  }
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+
   dest_node = uip_sr_get_node(dag, &UIP_IP_BUF->destipaddr);
   if(dest_node == NULL) {
     /* The destination is not found, skip SRH insertion */
@@ -457,6 +510,10 @@ insert_srh_header(void)
 
   /* The next hop (i.e. node whose parent is the root) is placed as the current IPv6 destination */
   NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
+#if UIP_SR_SRH_CACHE_SIZE
+  uip_sr_srh_store(dag, &UIP_IP_BUF->destipaddr, &node_addr,
+                   (uint8_t *)UIP_RH_BUF, ext_len);
+#endif /* UIP_SR_SRH_CACHE_SIZE */
   uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &node_addr);
 
   /* In-place update of IPv6 length field */
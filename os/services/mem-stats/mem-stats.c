@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \addtogroup mem-stats
+ * @{
+ */
+
+/**
+ * \file
+ *         Periodic log of the usage of the memory pools.
+ */
+
+#include "contiki.h"
+#include "lib/memb.h"
+#include "lib/heapmem.h"
+#include "mem-stats.h"
+
+/* Log configuration */
+#include "sys/log.h"
+#define LOG_MODULE "MemStats"
+#define LOG_LEVEL LOG_LEVEL_INFO
+
+PROCESS(mem_stats_process, "Memory statistics");
+/*---------------------------------------------------------------------------*/
+void
+mem_stats_reset(void)
+{
+  memb_stats_reset();
+#ifdef HEAPMEM_CONF_ARENA_SIZE
+  heapmem_stats_reset();
+#endif /* HEAPMEM_CONF_ARENA_SIZE */
+}
+/*---------------------------------------------------------------------------*/
+void
+mem_stats_log(void)
+{
+  static unsigned count = 0;
+  struct memb *m;
+#ifdef HEAPMEM_CONF_ARENA_SIZE
+  heapmem_stats_t stats;
+#endif /* HEAPMEM_CONF_ARENA_SIZE */
+
+  LOG_INFO("--- Memory usage #%u\n", count++);
+  for(m = memb_registry_head(); m != NULL; m = memb_registry_next(m)) {
+    LOG_INFO("%-24s %3u/%3u x %4u bytes, peak %3u, failures %u",
+             m->pool_name, m->used, m->num, m->size, m->used_max,
+             m->failures);
+    if(m->failures > 0) {
+      LOG_INFO_(" (last from %p)", m->failure_caller);
+    }
+    LOG_INFO_("\n");
+  }
+#ifdef HEAPMEM_CONF_ARENA_SIZE
+  heapmem_stats(&stats);
+  LOG_INFO("%-24s %lu/%lu bytes, peak footprint %lu, failures %lu",
+           "heapmem", (unsigned long)stats.allocated,
+           (unsigned long)HEAPMEM_CONF_ARENA_SIZE,
+           (unsigned long)stats.footprint_max,
+           (unsigned long)stats.alloc_failures);
+  if(stats.alloc_failures > 0) {
+    LOG_INFO_(" (last from %p)", stats.failure_caller);
+  }
+  LOG_INFO_("\n");
+#endif /* HEAPMEM_CONF_ARENA_SIZE */
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(mem_stats_process, ev, data)
+{
+  static struct etimer periodic_timer;
+  PROCESS_BEGIN();
+
+  etimer_set(&periodic_timer, MEM_STATS_PERIOD);
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&periodic_timer));
+    etimer_reset(&periodic_timer);
+    mem_stats_log();
+  }
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+mem_stats_init(void)
+{
+  if(MEM_STATS_PERIOD > 0) {
+    process_start(&mem_stats_process, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \addtogroup mem-stats
+ * @{
+ */
+
+/**
+ * \file
+ *         Tracks the usage of the memory pools: the peak usage, the
+ *         allocation failures and where the last failure came from,
+ *         for every MEMB pool (including the queuebuf pools) and for
+ *         the heapmem heap.
+ */
+
+#ifndef MEM_STATS_H_
+#define MEM_STATS_H_
+
+#include "contiki.h"
+
+/** \brief The period at which the memory usage is logged, 0 to disable */
+#ifdef MEM_STATS_CONF_PERIOD
+#define MEM_STATS_PERIOD MEM_STATS_CONF_PERIOD
+#else /* MEM_STATS_CONF_PERIOD */
+#define MEM_STATS_PERIOD (CLOCK_SECOND * 60)
+#endif /* MEM_STATS_CONF_PERIOD */
+
+/**
+ * Initialize the memory statistics and start the periodic log
+ */
+void mem_stats_init(void);
+
+/**
+ * Restart the peak usage and failure statistics of all pools
+ */
+void mem_stats_reset(void);
+
+/**
+ * Log the usage of all pools
+ */
+void mem_stats_log(void);
+
+#endif /* MEM_STATS_H_ */
+/** @} */
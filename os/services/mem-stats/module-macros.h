@@ -0,0 +1,2 @@
+#define BUILD_WITH_MEM_STATS 1
+#define MEMB_CONF_STATS 1
@@ -0,0 +1,3 @@
+#define BUILD_WITH_PROCESS_PROFILER 1
+#define PROCESS_CONF_PROFILER 1
+#define ENERGEST_CONF_ON 1
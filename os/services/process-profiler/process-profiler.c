@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \addtogroup process-profiler
+ * @{
+ */
+
+/**
+ * \file
+ *         A profiler that accumulates the time spent in every process,
+ *         per event type, and periodically prints it out along with
+ *         the CPU time measured by Energest.
+ */
+
+#include "contiki.h"
+#include "sys/energest.h"
+#include "process-profiler.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* Log configuration */
+#include "sys/log.h"
+#define LOG_MODULE "Profiler"
+#define LOG_LEVEL LOG_LEVEL_INFO
+
+/* Entries are found by hashing the process and event, with linear
+   probing. They are only freed all at once, by a reset. */
+static struct process_profiler_entry entries[PROCESS_PROFILER_ENTRIES];
+static uint32_t dropped;
+static uint64_t period_start_time, period_start_cpu;
+
+PROCESS(process_profiler_process, "Process profiler");
+/*---------------------------------------------------------------------------*/
+static unsigned
+entry_hash(struct process *p, process_event_t ev)
+{
+  uintptr_t h = (uintptr_t)p;
+
+  h ^= h >> 7;
+  return (unsigned)((h ^ (ev * 31u)) % PROCESS_PROFILER_ENTRIES);
+}
+/*---------------------------------------------------------------------------*/
+void
+process_profiler_record(struct process *p, process_event_t ev,
+                        rtimer_clock_t ticks)
+{
+  struct process_profiler_entry *e;
+  unsigned i, n;
+
+  i = entry_hash(p, ev);
+  for(n = 0; n < PROCESS_PROFILER_ENTRIES; n++) {
+    e = &entries[i];
+    if(e->p == NULL) {
+      e->p = p;
+      e->ev = ev;
+    }
+    if(e->p == p && e->ev == ev) {
+      e->calls++;
+      e->ticks += ticks;
+      if(ticks > e->max) {
+        e->max = ticks;
+      }
+      return;
+    }
+    i = (i + 1) % PROCESS_PROFILER_ENTRIES;
+  }
+  dropped++;
+}
+/*---------------------------------------------------------------------------*/
+const struct process_profiler_entry *
+process_profiler_entry(int i)
+{
+  if(i < 0 || i >= PROCESS_PROFILER_ENTRIES || entries[i].p == NULL) {
+    return NULL;
+  }
+  return &entries[i];
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+process_profiler_dropped(void)
+{
+  return dropped;
+}
+/*---------------------------------------------------------------------------*/
+const char *
+process_profiler_event_name(process_event_t ev)
+{
+  static const char *const names[] = {
+    "none", "init", "poll", "exit", "service-removed", "continue", "msg",
+    "exited", "timer", "com"
+  };
+
+  if(ev >= PROCESS_EVENT_NONE && ev < PROCESS_EVENT_MAX) {
+    return names[ev - PROCESS_EVENT_NONE];
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+void
+process_profiler_reset(void)
+{
+  memset(entries, 0, sizeof(entries));
+  dropped = 0;
+  energest_flush();
+  period_start_time = ENERGEST_GET_TOTAL_TIME();
+  period_start_cpu = energest_type_time(ENERGEST_TYPE_CPU);
+}
+/*---------------------------------------------------------------------------*/
+void
+process_profiler_log(void)
+{
+  static unsigned count = 0;
+  uint16_t order[PROCESS_PROFILER_ENTRIES];
+  uint64_t delta_time, delta_cpu;
+  const struct process_profiler_entry *e;
+  const char *name;
+  int i, j, n;
+
+  energest_flush();
+  delta_time = ENERGEST_GET_TOTAL_TIME() - period_start_time;
+  delta_cpu = energest_type_time(ENERGEST_TYPE_CPU) - period_start_cpu;
+
+  /* Sort the entries in use by decreasing time */
+  n = 0;
+  for(i = 0; i < PROCESS_PROFILER_ENTRIES; i++) {
+    if(entries[i].p != NULL) {
+      for(j = n; j > 0 && entries[order[j - 1]].ticks < entries[i].ticks; j--) {
+        order[j] = order[j - 1];
+      }
+      order[j] = i;
+      n++;
+    }
+  }
+
+  LOG_INFO("--- Process profile #%u (%lu seconds)\n", count++,
+           (unsigned long)(delta_time / ENERGEST_SECOND));
+  LOG_INFO("CPU         : %10lu/%10lu energest ticks\n",
+           (unsigned long)delta_cpu, (unsigned long)delta_time);
+  for(i = 0; i < n; i++) {
+    e = &entries[order[i]];
+    name = process_profiler_event_name(e->ev);
+    if(name != NULL) {
+      LOG_INFO("%-20s %-8s", PROCESS_NAME_STRING(e->p), name);
+    } else {
+      LOG_INFO("%-20s 0x%02x    ", PROCESS_NAME_STRING(e->p), e->ev);
+    }
+    LOG_INFO_(" calls %8lu, time %10lu, max %8lu (%lu permil of CPU)\n",
+              (unsigned long)e->calls, (unsigned long)e->ticks,
+              (unsigned long)e->max,
+              delta_cpu == 0 ? 0 : (unsigned long)
+              ((uint64_t)e->ticks * ENERGEST_SECOND * 1000
+               / RTIMER_SECOND / delta_cpu));
+  }
+  if(dropped > 0) {
+    LOG_INFO("Calls not profiled: %lu\n", (unsigned long)dropped);
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(process_profiler_process, ev, data)
+{
+  static struct etimer periodic_timer;
+  PROCESS_BEGIN();
+
+  etimer_set(&periodic_timer, PROCESS_PROFILER_PERIOD);
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&periodic_timer));
+    etimer_reset(&periodic_timer);
+    process_profiler_log();
+    process_profiler_reset();
+  }
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+process_profiler_init(void)
+{
+  process_profiler_reset();
+  if(PROCESS_PROFILER_PERIOD > 0) {
+    process_start(&process_profiler_process, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
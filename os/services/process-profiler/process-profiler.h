@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \addtogroup process-profiler
+ * @{
+ */
+
+/**
+ * \file
+ *         A profiler that accumulates the time spent in every process,
+ *         per event type, and periodically prints it out along with
+ *         the CPU time measured by Energest.
+ */
+
+#ifndef PROCESS_PROFILER_H_
+#define PROCESS_PROFILER_H_
+
+#include "contiki.h"
+
+/** \brief The number of (process, event) pairs that can be profiled */
+#ifdef PROCESS_PROFILER_CONF_ENTRIES
+#define PROCESS_PROFILER_ENTRIES PROCESS_PROFILER_CONF_ENTRIES
+#else /* PROCESS_PROFILER_CONF_ENTRIES */
+#define PROCESS_PROFILER_ENTRIES 32
+#endif /* PROCESS_PROFILER_CONF_ENTRIES */
+
+/** \brief The period at which the profile is logged and reset, 0 to disable */
+#ifdef PROCESS_PROFILER_CONF_PERIOD
+#define PROCESS_PROFILER_PERIOD PROCESS_PROFILER_CONF_PERIOD
+#else /* PROCESS_PROFILER_CONF_PERIOD */
+#define PROCESS_PROFILER_PERIOD (CLOCK_SECOND * 60)
+#endif /* PROCESS_PROFILER_CONF_PERIOD */
+
+/**
+ * The time spent in a process handling one type of event
+ */
+struct process_profiler_entry {
+  struct process *p;
+  process_event_t ev;
+  /** Number of calls to the process with this event */
+  uint32_t calls;
+  /** Total time spent in these calls, in rtimer ticks */
+  uint32_t ticks;
+  /** Longest of these calls, in rtimer ticks */
+  rtimer_clock_t max;
+};
+
+/**
+ * Initialize the profiler and start the periodic log
+ */
+void process_profiler_init(void);
+
+/**
+ * Record a call to a process. Called by the process module.
+ *
+ * \param p The process that was called
+ * \param ev The event the process was called with
+ * \param ticks The time spent in the process, in rtimer ticks
+ */
+void process_profiler_record(struct process *p, process_event_t ev,
+                             rtimer_clock_t ticks);
+
+/**
+ * Get a profile entry
+ *
+ * \param i The index of the entry, from 0 to PROCESS_PROFILER_ENTRIES - 1
+ * \return The entry, or NULL if it is unused
+ */
+const struct process_profiler_entry *process_profiler_entry(int i);
+
+/**
+ * Get the number of calls that were not profiled because all entries
+ * were in use
+ */
+uint32_t process_profiler_dropped(void);
+
+/**
+ * Get the name of a system event
+ *
+ * \return The name of the event, or NULL for events allocated with
+ * process_alloc_event()
+ */
+const char *process_profiler_event_name(process_event_t ev);
+
+/**
+ * Clear the profile and start a new period
+ */
+void process_profiler_reset(void);
+
+/**
+ * Log the profile of the current period
+ */
+void process_profiler_log(void);
+
+#endif /* PROCESS_PROFILER_H_ */
+/** @} */
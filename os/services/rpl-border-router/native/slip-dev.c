@@ -289,6 +289,8 @@ after_fread:
 unsigned char slip_buf[2048];
 int slip_end, slip_begin, slip_packet_end, slip_packet_count;
 static struct timer send_delay_timer;
+/* Schedules a wake-up of the tickless main loop when the delay is over */
+static struct ctimer send_delay_wakeup;
 /* delay between slip packets */
 static clock_time_t send_delay = SEND_DELAY;
 /*---------------------------------------------------------------------------*/
@@ -352,6 +354,7 @@ slip_flushbuf(int fd)
         /* a delay between slip packets to avoid losing data */
         if(send_delay > 0) {
           timer_set(&send_delay_timer, send_delay);
+          ctimer_set(&send_delay_wakeup, send_delay, NULL, NULL);
         }
       }
     }
@@ -47,6 +47,7 @@
 #include "shell-commands.h"
 #include "lib/list.h"
 #include "sys/log.h"
+#include "sys/stack-check.h"
 #include "dev/watchdog.h"
 #include "net/ipv6/uip.h"
 #include "net/ipv6/uiplib.h"
@@ -57,6 +58,14 @@
 #endif /* MAC_CONF_WITH_TSCH */
 #include "net/routing/routing.h"
 #include "net/mac/llsec802154.h"
+#if BUILD_WITH_PROCESS_PROFILER
+#include "services/process-profiler/process-profiler.h"
+#endif /* BUILD_WITH_PROCESS_PROFILER */
+#if BUILD_WITH_MEM_STATS
+#include "services/mem-stats/mem-stats.h"
+#include "lib/memb.h"
+#include "lib/heapmem.h"
+#endif /* BUILD_WITH_MEM_STATS */
 
 /* For RPL-specific commands */
 #if ROUTING_CONF_RPL_LITE
@@ -506,6 +515,175 @@ PT_THREAD(cmd_ip_neighbors(struct pt *pt, shell_output_func output, char *args))
   PT_END(pt);
 
 }
+#if PROCESS_STATS
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_process_stats(struct pt *pt, shell_output_func output, char *args))
+{
+  struct process *p;
+  char *next_args;
+
+  PT_BEGIN(pt);
+
+  SHELL_ARGS_INIT(args, next_args);
+
+  /* Get argument (reset) */
+  SHELL_ARGS_NEXT(args, next_args);
+  if(args != NULL) {
+    if(!strcmp(args, "reset")) {
+      process_stats_reset();
+      SHELL_OUTPUT(output, "Process statistics reset\n");
+    } else {
+      SHELL_OUTPUT(output, "Invalid argument: %s\n", args);
+    }
+    PT_EXIT(pt);
+  }
+
+  SHELL_OUTPUT(output, "Event queue: %u/%u events, max %u, overflows %lu\n",
+               process_nevents(), process_event_queue_size(),
+               process_maxevents, (unsigned long)process_overflows);
+  SHELL_OUTPUT(output, "Processes (runtime in %lu ticks per second):\n",
+               (unsigned long)RTIMER_SECOND);
+  for(p = PROCESS_LIST(); p != NULL; p = p->next) {
+    SHELL_OUTPUT(output, "-- %s: events %lu, runtime %lu, overflows %u\n",
+                 PROCESS_NAME_STRING(p), (unsigned long)p->stats.events,
+                 (unsigned long)p->stats.runtime, p->stats.overflows);
+  }
+
+  PT_END(pt);
+}
+#endif /* PROCESS_STATS */
+#if STACK_CHECK_ENABLED
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_stack_usage(struct pt *pt, shell_output_func output, char *args))
+{
+#if STACK_CHECK_PER_PROCESS
+  struct process *p;
+#endif /* STACK_CHECK_PER_PROCESS */
+
+  PT_BEGIN(pt);
+
+  SHELL_OUTPUT(output, "Stack usage: %u bytes, reserved: %u bytes\n",
+               stack_check_get_usage(), stack_check_get_reserved_size());
+#if STACK_CHECK_PER_PROCESS
+  SHELL_OUTPUT(output, "Peak usage per context:\n");
+  SHELL_OUTPUT(output, "-- real-time tasks: %u bytes\n",
+               stack_check_interrupt_peak);
+  for(p = PROCESS_LIST(); p != NULL; p = p->next) {
+    SHELL_OUTPUT(output, "-- %s: %u bytes\n",
+                 PROCESS_NAME_STRING(p), p->stack_peak);
+  }
+#endif /* STACK_CHECK_PER_PROCESS */
+
+  PT_END(pt);
+}
+#endif /* STACK_CHECK_ENABLED */
+#if BUILD_WITH_PROCESS_PROFILER
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_process_profile(struct pt *pt, shell_output_func output, char *args))
+{
+  const struct process_profiler_entry *e;
+  const char *name;
+  char *next_args;
+  int i;
+
+  PT_BEGIN(pt);
+
+  SHELL_ARGS_INIT(args, next_args);
+
+  /* Get argument (reset) */
+  SHELL_ARGS_NEXT(args, next_args);
+  if(args != NULL) {
+    if(!strcmp(args, "reset")) {
+      process_profiler_reset();
+      SHELL_OUTPUT(output, "Process profile reset\n");
+    } else {
+      SHELL_OUTPUT(output, "Invalid argument: %s\n", args);
+    }
+    PT_EXIT(pt);
+  }
+
+  SHELL_OUTPUT(output, "Process profile (time in %lu ticks per second):\n",
+               (unsigned long)RTIMER_SECOND);
+  for(i = 0; i < PROCESS_PROFILER_ENTRIES; i++) {
+    e = process_profiler_entry(i);
+    if(e == NULL) {
+      continue;
+    }
+    name = process_profiler_event_name(e->ev);
+    SHELL_OUTPUT(output, "-- %s, ", PROCESS_NAME_STRING(e->p));
+    if(name != NULL) {
+      SHELL_OUTPUT(output, "%s", name);
+    } else {
+      SHELL_OUTPUT(output, "0x%02x", e->ev);
+    }
+    SHELL_OUTPUT(output, ": calls %lu, time %lu, max %lu\n",
+                 (unsigned long)e->calls, (unsigned long)e->ticks,
+                 (unsigned long)e->max);
+  }
+  if(process_profiler_dropped() > 0) {
+    SHELL_OUTPUT(output, "Calls not profiled: %lu\n",
+                 (unsigned long)process_profiler_dropped());
+  }
+
+  PT_END(pt);
+}
+#endif /* BUILD_WITH_PROCESS_PROFILER */
+#if BUILD_WITH_MEM_STATS
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_mem_stats(struct pt *pt, shell_output_func output, char *args))
+{
+  struct memb *m;
+#ifdef HEAPMEM_CONF_ARENA_SIZE
+  heapmem_stats_t stats;
+#endif /* HEAPMEM_CONF_ARENA_SIZE */
+  char *next_args;
+
+  PT_BEGIN(pt);
+
+  SHELL_ARGS_INIT(args, next_args);
+
+  /* Get argument (reset) */
+  SHELL_ARGS_NEXT(args, next_args);
+  if(args != NULL) {
+    if(!strcmp(args, "reset")) {
+      mem_stats_reset();
+      SHELL_OUTPUT(output, "Memory statistics reset\n");
+    } else {
+      SHELL_OUTPUT(output, "Invalid argument: %s\n", args);
+    }
+    PT_EXIT(pt);
+  }
+
+  SHELL_OUTPUT(output, "Memory pools:\n");
+  for(m = memb_registry_head(); m != NULL; m = memb_registry_next(m)) {
+    SHELL_OUTPUT(output, "-- %s: used %u/%u (%u bytes each), peak %u, failures %u",
+                 m->pool_name, m->used, m->num, m->size, m->used_max,
+                 m->failures);
+    if(m->failures > 0) {
+      SHELL_OUTPUT(output, ", last from %p", m->failure_caller);
+    }
+    SHELL_OUTPUT(output, "\n");
+  }
+#ifdef HEAPMEM_CONF_ARENA_SIZE
+  heapmem_stats(&stats);
+  SHELL_OUTPUT(output, "-- heapmem: allocated %lu/%lu bytes, peak footprint %lu, failures %lu",
+               (unsigned long)stats.allocated,
+               (unsigned long)HEAPMEM_CONF_ARENA_SIZE,
+               (unsigned long)stats.footprint_max,
+               (unsigned long)stats.alloc_failures);
+  if(stats.alloc_failures > 0) {
+    SHELL_OUTPUT(output, ", last from %p", stats.failure_caller);
+  }
+  SHELL_OUTPUT(output, "\n");
+#endif /* HEAPMEM_CONF_ARENA_SIZE */
+
+  PT_END(pt);
+}
+#endif /* BUILD_WITH_MEM_STATS */
 #if MAC_CONF_WITH_TSCH
 /*---------------------------------------------------------------------------*/
 static
@@ -780,6 +958,18 @@ const struct shell_command_t builtin_shell_commands[] = {
   { "ip-nbr",               cmd_ip_neighbors,         "'> ip-nbr': Shows all IPv6 neighbors" },
   { "log",                  cmd_log,                  "'> log module level': Sets log level (0--4) for a given module (or \"all\"). For module \"mac\", level 4 also enables per-slot logging." },
   { "ping",                 cmd_ping,                 "'> ping addr': Pings the IPv6 address 'addr'" },
+#if PROCESS_STATS
+  { "process-stats",        cmd_process_stats,        "'> process-stats [reset]': Shows (or resets) the event queue and per-process statistics" },
+#endif /* PROCESS_STATS */
+#if STACK_CHECK_ENABLED
+  { "stack-usage",          cmd_stack_usage,          "'> stack-usage': Shows the stack usage, per process if enabled" },
+#endif /* STACK_CHECK_ENABLED */
+#if BUILD_WITH_PROCESS_PROFILER
+  { "process-profile",      cmd_process_profile,      "'> process-profile [reset]': Shows (or resets) the time spent per process and event" },
+#endif /* BUILD_WITH_PROCESS_PROFILER */
+#if BUILD_WITH_MEM_STATS
+  { "mem-stats",            cmd_mem_stats,            "'> mem-stats [reset]': Shows (or resets) the peak usage and failures of the memory pools" },
+#endif /* BUILD_WITH_MEM_STATS */
 #if UIP_CONF_IPV6_RPL
   { "rpl-set-root",         cmd_rpl_set_root,         "'> rpl-set-root 0/1 [prefix]': Sets node as root (1) or not (0). A /64 prefix can be optionally specified." },
   { "rpl-local-repair",     cmd_rpl_local_repair,     "'> rpl-local-repair': Triggers a RPL local repair" },
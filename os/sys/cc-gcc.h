@@ -39,5 +39,7 @@
 
 #define CC_CONF_ALIGN(n) __attribute__((__aligned__(n)))
 
+#define CC_CONF_NO_INLINE __attribute__((__noinline__))
+
 #endif /* __GNUC__ */
 #endif /* _CC_GCC_H_ */
@@ -105,6 +105,15 @@
 #define CC_ALIGN(n) CC_CONF_ALIGN(n)
 #endif /* CC_CONF_INLINE */
 
+/**
+ * Configure how to keep the C compiler from inlining a function.
+ */
+#ifdef CC_CONF_NO_INLINE
+#define CC_NO_INLINE CC_CONF_NO_INLINE
+#else /* CC_CONF_NO_INLINE */
+#define CC_NO_INLINE
+#endif /* CC_CONF_NO_INLINE */
+
 /**
  * Configure if the C compiler supports the assignment of struct value.
  */
@@ -133,6 +142,18 @@
 #define NULL 0
 #endif /* NULL */
 
+/** \def CC_RETURN_ADDRESS()
+ * The address that the current function will return to, i.e. a
+ * pointer into its caller, or NULL if the compiler cannot tell.
+ */
+#ifdef CC_CONF_RETURN_ADDRESS
+#define CC_RETURN_ADDRESS() CC_CONF_RETURN_ADDRESS()
+#elif defined(__GNUC__)
+#define CC_RETURN_ADDRESS() __builtin_return_address(0)
+#else /* CC_CONF_RETURN_ADDRESS */
+#define CC_RETURN_ADDRESS() NULL
+#endif /* CC_CONF_RETURN_ADDRESS */
+
 #ifndef MAX
 #define MAX(n, m)   (((n) < (m)) ? (m) : (n))
 #endif
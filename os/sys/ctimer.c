@@ -46,8 +46,6 @@
 #include "contiki.h"
 #include "lib/list.h"
 
-LIST(ctimer_list);
-
 static char initialized;
 
 #define DEBUG 0
@@ -60,6 +58,287 @@ static char initialized;
 
 /*---------------------------------------------------------------------------*/
 PROCESS(ctimer_process, "Ctimer process");
+#if CTIMER_WITH_HEAP
+/* Root of the pairing heap of pending callback timers. Siblings are
+   chained through the next pointer, and the prev pointer of a timer
+   points to its left sibling, or to its parent if it is the leftmost
+   child. ctimer_process waits on a single event timer set for the
+   root. The etimer embedded in each ctimer only holds its timer, and
+   its process pointer tells whether the ctimer is pending. */
+static struct ctimer *ctimerheap;
+static struct etimer next_etimer;
+
+/* True if the ctimer is in the heap. As with event timers, a marker
+   pointing to the ctimer itself is not found in garbage. */
+#define IN_HEAP(c) ((c)->in_heap == (c))
+/* True if the ctimer a expires before the ctimer b, accounting for
+   wrapping of the clock. */
+#define EXPIRATION(c) ((c)->etimer.timer.start + (c)->etimer.timer.interval)
+#define EXPIRES_BEFORE(a, b) \
+  ((clock_time_t)(EXPIRATION(a) - EXPIRATION(b)) > ((clock_time_t)~0 >> 1))
+/*---------------------------------------------------------------------------*/
+static struct ctimer *
+heap_meld(struct ctimer *a, struct ctimer *b)
+{
+  struct ctimer *tmp;
+
+  if(a == NULL) {
+    return b;
+  }
+  if(b == NULL) {
+    return a;
+  }
+  if(EXPIRES_BEFORE(b, a)) {
+    tmp = a;
+    a = b;
+    b = tmp;
+  }
+
+  /* Make b the leftmost child of a */
+  b->prev = a;
+  b->next = a->child;
+  if(a->child != NULL) {
+    a->child->prev = b;
+  }
+  a->child = b;
+
+  return a;
+}
+/*---------------------------------------------------------------------------*/
+static struct ctimer *
+heap_merge_pairs(struct ctimer *first)
+{
+  struct ctimer *a, *b, *pairs, *heap;
+
+  /* First pass: meld the siblings two by two, from left to right, and
+     chain the resulting heaps in reverse order. */
+  pairs = NULL;
+  while(first != NULL) {
+    a = first;
+    b = a->next;
+    first = b != NULL ? b->next : NULL;
+
+    a->next = a->prev = NULL;
+    if(b != NULL) {
+      b->next = b->prev = NULL;
+    }
+    a = heap_meld(a, b);
+    a->next = pairs;
+    pairs = a;
+  }
+
+  /* Second pass: meld the resulting heaps from right to left. */
+  heap = NULL;
+  while(pairs != NULL) {
+    a = pairs;
+    pairs = a->next;
+    a->next = NULL;
+    heap = heap_meld(heap, a);
+  }
+
+  return heap;
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_insert(struct ctimer *c)
+{
+  c->child = c->next = c->prev = NULL;
+  c->in_heap = c;
+  ctimerheap = heap_meld(ctimerheap, c);
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_remove(struct ctimer *c)
+{
+  if(c == ctimerheap) {
+    ctimerheap = heap_merge_pairs(c->child);
+  } else {
+    /* Cut c and its subtree from the heap */
+    if(c->prev->child == c) {
+      c->prev->child = c->next;
+    } else {
+      c->prev->next = c->next;
+    }
+    if(c->next != NULL) {
+      c->next->prev = c->prev;
+    }
+    ctimerheap = heap_meld(ctimerheap, heap_merge_pairs(c->child));
+  }
+  c->child = c->next = c->prev = c->in_heap = NULL;
+}
+/*---------------------------------------------------------------------------*/
+static struct ctimer *
+heap_parent(struct ctimer *c)
+{
+  while(c->prev != NULL && c->prev->child != c) {
+    c = c->prev;
+  }
+  return c->prev;
+}
+/*---------------------------------------------------------------------------*/
+static int
+count_due(void)
+{
+  struct ctimer *c;
+  int due;
+
+  /* The timers that are due form a subtree at the root of the heap.
+     Walk it depth first, without recursion. */
+  due = 0;
+  c = ctimerheap;
+  while(c != NULL) {
+    if(timer_expired(&c->etimer.timer)) {
+      due++;
+      if(c->child != NULL) {
+        c = c->child;
+        continue;
+      }
+    }
+    while(c != NULL && c->next == NULL) {
+      c = heap_parent(c);
+    }
+    if(c != NULL) {
+      c = c->next;
+    }
+  }
+  return due;
+}
+/*---------------------------------------------------------------------------*/
+static void
+update_etimer(void)
+{
+  if(!initialized) {
+    return;
+  }
+
+  PROCESS_CONTEXT_BEGIN(&ctimer_process);
+  if(ctimerheap == NULL) {
+    etimer_stop(&next_etimer);
+  } else if(timer_expired(&ctimerheap->etimer.timer)) {
+    etimer_set(&next_etimer, 0);
+  } else {
+    etimer_set(&next_etimer, timer_remaining(&ctimerheap->etimer.timer));
+  }
+  PROCESS_CONTEXT_END(&ctimer_process);
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_ctimer(struct ctimer *c)
+{
+  struct ctimer *root;
+
+  root = ctimerheap;
+  if(IN_HEAP(c)) {
+    heap_remove(c);
+  }
+  heap_insert(c);
+  c->etimer.p = &ctimer_process;
+
+  if(ctimerheap != root || c == root) {
+    update_etimer();
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(ctimer_process, ev, data)
+{
+  struct ctimer *c;
+  static int due;
+
+  PROCESS_BEGIN();
+
+  initialized = 1;
+  update_etimer();
+
+  while(1) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_TIMER);
+
+    /* Count the timers that are due before calling any callback, so
+       that a callback re-arming its own timer cannot keep us here. */
+    due = count_due();
+
+    while(due-- > 0) {
+      c = ctimerheap;
+      if(c == NULL || !timer_expired(&c->etimer.timer)) {
+        break;
+      }
+      heap_remove(c);
+      c->etimer.p = PROCESS_NONE;
+      PROCESS_CONTEXT_BEGIN(c->p);
+      if(c->f != NULL) {
+        c->f(c->ptr);
+      }
+      PROCESS_CONTEXT_END(c->p);
+    }
+
+    update_etimer();
+  }
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+ctimer_init(void)
+{
+  initialized = 0;
+  ctimerheap = NULL;
+  process_start(&ctimer_process, NULL);
+}
+/*---------------------------------------------------------------------------*/
+void
+ctimer_set_with_process(struct ctimer *c, clock_time_t t,
+	   void (*f)(void *), void *ptr, struct process *p)
+{
+  PRINTF("ctimer_set %p %lu\n", c, (unsigned long)t);
+  c->p = p;
+  c->f = f;
+  c->ptr = ptr;
+  timer_set(&c->etimer.timer, t);
+  add_ctimer(c);
+}
+/*---------------------------------------------------------------------------*/
+void
+ctimer_reset(struct ctimer *c)
+{
+  timer_reset(&c->etimer.timer);
+  add_ctimer(c);
+}
+/*---------------------------------------------------------------------------*/
+void
+ctimer_restart(struct ctimer *c)
+{
+  timer_restart(&c->etimer.timer);
+  add_ctimer(c);
+}
+/*---------------------------------------------------------------------------*/
+void
+ctimer_stop(struct ctimer *c)
+{
+  int was_root;
+
+  was_root = c == ctimerheap;
+  if(IN_HEAP(c)) {
+    heap_remove(c);
+  }
+  c->etimer.next = NULL;
+  c->etimer.p = PROCESS_NONE;
+  if(was_root) {
+    update_etimer();
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+ctimer_expired(struct ctimer *c)
+{
+  return !IN_HEAP(c);
+}
+/*---------------------------------------------------------------------------*/
+clock_time_t
+ctimer_next_expiration_time(void)
+{
+  return ctimerheap != NULL ? EXPIRATION(ctimerheap) : 0;
+}
+#else /* CTIMER_WITH_HEAP */
+LIST(ctimer_list);
+
 PROCESS_THREAD(ctimer_process, ev, data)
 {
   struct ctimer *c;
@@ -96,13 +375,6 @@ ctimer_init(void)
 }
 /*---------------------------------------------------------------------------*/
 void
-ctimer_set(struct ctimer *c, clock_time_t t,
-	   void (*f)(void *), void *ptr)
-{
-  ctimer_set_with_process(c, t, f, ptr, PROCESS_CURRENT());
-}
-/*---------------------------------------------------------------------------*/
-void
 ctimer_set_with_process(struct ctimer *c, clock_time_t t,
 	   void (*f)(void *), void *ptr, struct process *p)
 {
@@ -172,4 +444,33 @@ ctimer_expired(struct ctimer *c)
   return 1;
 }
 /*---------------------------------------------------------------------------*/
+clock_time_t
+ctimer_next_expiration_time(void)
+{
+  struct ctimer *c;
+  clock_time_t next, now;
+
+  /* Must measure the distance to each timer due to wraps */
+  c = list_head(ctimer_list);
+  if(c == NULL) {
+    return 0;
+  }
+  now = clock_time();
+  next = c->etimer.timer.start + c->etimer.timer.interval;
+  for(c = c->next; c != NULL; c = c->next) {
+    if(c->etimer.timer.start + c->etimer.timer.interval - now < next - now) {
+      next = c->etimer.timer.start + c->etimer.timer.interval;
+    }
+  }
+  return next;
+}
+#endif /* CTIMER_WITH_HEAP */
+/*---------------------------------------------------------------------------*/
+void
+ctimer_set(struct ctimer *c, clock_time_t t,
+	   void (*f)(void *), void *ptr)
+{
+  ctimer_set_with_process(c, t, f, ptr, PROCESS_CURRENT());
+}
+/*---------------------------------------------------------------------------*/
 /** @} */
@@ -57,12 +57,38 @@
 #include "contiki.h"
 #include "sys/etimer.h"
 
+/**
+ * \brief Keep callback timers in a heap ordered by expiration time
+ *
+ * By default, every callback timer is backed by its own event timer.
+ * When CTIMER_CONF_WITH_HEAP is set, the pending callback timers are
+ * instead kept in an intrusive pairing heap ordered by expiration
+ * time, and the ctimer process waits on a single event timer set for
+ * the first one. Setting and stopping a timer cost O(log n) amortized,
+ * all callbacks that are due are called in one pass, and the next
+ * expiration time is read from the root of the heap.
+ *
+ * As with event timers, a callback timer need not be initialized
+ * before it is set or stopped. Pending timers must expire within half
+ * the range of clock_time_t of each other.
+ */
+#ifdef CTIMER_CONF_WITH_HEAP
+#define CTIMER_WITH_HEAP CTIMER_CONF_WITH_HEAP
+#else /* CTIMER_CONF_WITH_HEAP */
+#define CTIMER_WITH_HEAP 0
+#endif /* CTIMER_CONF_WITH_HEAP */
+
 struct ctimer {
   struct ctimer *next;
   struct etimer etimer;
   struct process *p;
   void (*f)(void *);
   void *ptr;
+#if CTIMER_WITH_HEAP
+  struct ctimer *child;
+  struct ctimer *prev;
+  struct ctimer *in_heap;
+#endif /* CTIMER_WITH_HEAP */
 };
 
 /**
@@ -155,6 +181,16 @@ void ctimer_stop(struct ctimer *c);
  */
 int ctimer_expired(struct ctimer *c);
 
+/**
+ * \brief      Get the expiration time of the next callback timer.
+ * \return     The expiration time of the first pending callback timer,
+ *             or 0 if there are no pending callback timers.
+ *
+ *             With CTIMER_CONF_WITH_HEAP, this function runs in
+ *             constant time.
+ */
+clock_time_t ctimer_next_expiration_time(void);
+
 /**
  * \brief      Initialize the callback timer library.
  *
@@ -49,11 +49,227 @@
 #include "sys/etimer.h"
 #include "sys/process.h"
 
+#if ETIMER_WITH_HEAP
+/* Root of the pairing heap. Siblings are chained through the next
+   pointer, and the prev pointer of a timer points to its left sibling,
+   or to its parent if it is the leftmost child. */
+static struct etimer *timerheap;
+#else /* ETIMER_WITH_HEAP */
 static struct etimer *timerlist;
+#endif /* ETIMER_WITH_HEAP */
 static clock_time_t next_expiration;
 
 PROCESS(etimer_process, "Event timer");
 /*---------------------------------------------------------------------------*/
+#if ETIMER_WITH_HEAP
+/* True if the timer is in the heap. The process of a timer is not
+   trusted for this, as it is garbage in a timer that was never set. */
+#define IN_HEAP(t) ((t)->in_heap == (t))
+/* True if timer a expires before timer b. Wrapping is accounted for by
+   looking at the sign of the difference between the expiration times. */
+#define EXPIRATION(t) ((t)->timer.start + (t)->timer.interval)
+#define EXPIRES_BEFORE(a, b) \
+  ((clock_time_t)(EXPIRATION(a) - EXPIRATION(b)) > ((clock_time_t)~0 >> 1))
+/*---------------------------------------------------------------------------*/
+static struct etimer *
+heap_meld(struct etimer *a, struct etimer *b)
+{
+  struct etimer *tmp;
+
+  if(a == NULL) {
+    return b;
+  }
+  if(b == NULL) {
+    return a;
+  }
+  if(EXPIRES_BEFORE(b, a)) {
+    tmp = a;
+    a = b;
+    b = tmp;
+  }
+
+  /* Make b the leftmost child of a */
+  b->prev = a;
+  b->next = a->child;
+  if(a->child != NULL) {
+    a->child->prev = b;
+  }
+  a->child = b;
+
+  return a;
+}
+/*---------------------------------------------------------------------------*/
+static struct etimer *
+heap_merge_pairs(struct etimer *first)
+{
+  struct etimer *a, *b, *pairs, *heap;
+
+  /* First pass: meld the siblings two by two, from left to right, and
+     chain the resulting heaps in reverse order. */
+  pairs = NULL;
+  while(first != NULL) {
+    a = first;
+    b = a->next;
+    first = b != NULL ? b->next : NULL;
+
+    a->next = a->prev = NULL;
+    if(b != NULL) {
+      b->next = b->prev = NULL;
+    }
+    a = heap_meld(a, b);
+    a->next = pairs;
+    pairs = a;
+  }
+
+  /* Second pass: meld the resulting heaps from right to left. */
+  heap = NULL;
+  while(pairs != NULL) {
+    a = pairs;
+    pairs = a->next;
+    a->next = NULL;
+    heap = heap_meld(heap, a);
+  }
+
+  return heap;
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_insert(struct etimer *t)
+{
+  t->child = t->next = t->prev = NULL;
+  t->in_heap = t;
+  timerheap = heap_meld(timerheap, t);
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_remove(struct etimer *t)
+{
+  if(t == timerheap) {
+    timerheap = heap_merge_pairs(t->child);
+  } else {
+    /* Cut t and its subtree from the heap */
+    if(t->prev->child == t) {
+      t->prev->child = t->next;
+    } else {
+      t->prev->next = t->next;
+    }
+    if(t->next != NULL) {
+      t->next->prev = t->prev;
+    }
+    timerheap = heap_meld(timerheap, heap_merge_pairs(t->child));
+  }
+  t->child = t->next = t->prev = t->in_heap = NULL;
+}
+/*---------------------------------------------------------------------------*/
+static struct etimer *
+heap_parent(struct etimer *t)
+{
+  while(t->prev != NULL && t->prev->child != t) {
+    t = t->prev;
+  }
+  return t->prev;
+}
+/*---------------------------------------------------------------------------*/
+static struct etimer *
+heap_find_process(struct process *p)
+{
+  struct etimer *t;
+
+  /* Depth-first walk of the heap, without recursion */
+  t = timerheap;
+  while(t != NULL) {
+    if(t->p == p) {
+      return t;
+    }
+    if(t->child != NULL) {
+      t = t->child;
+    } else {
+      while(t != NULL && t->next == NULL) {
+        t = heap_parent(t);
+      }
+      if(t != NULL) {
+        t = t->next;
+      }
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+update_time(void)
+{
+  next_expiration = timerheap != NULL ? EXPIRATION(timerheap) : 0;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(etimer_process, ev, data)
+{
+  struct etimer *t;
+
+  PROCESS_BEGIN();
+
+  timerheap = NULL;
+
+  while(1) {
+    PROCESS_YIELD();
+
+    if(ev == PROCESS_EVENT_EXITED) {
+      struct process *p = data;
+
+      while((t = heap_find_process(p)) != NULL) {
+        heap_remove(t);
+        t->p = PROCESS_NONE;
+      }
+      update_time();
+      continue;
+    } else if(ev != PROCESS_EVENT_POLL) {
+      continue;
+    }
+
+    /* The root of the heap is the timer to expire first: stop as soon
+       as it has not expired yet. */
+    while(timerheap != NULL && timer_expired(&timerheap->timer)) {
+      t = timerheap;
+      if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
+        /* Reset the process ID of the event timer, to signal that the
+           etimer has expired. This is later checked in the
+           etimer_expired() function. */
+        t->p = PROCESS_NONE;
+        heap_remove(t);
+      } else {
+        /* The event queue is full, try again later */
+        etimer_request_poll();
+        break;
+      }
+    }
+    update_time();
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+etimer_request_poll(void)
+{
+  process_poll(&etimer_process);
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_timer(struct etimer *timer)
+{
+  etimer_request_poll();
+
+  if(IN_HEAP(timer)) {
+    /* Timer already in the heap, its expiration time may have changed */
+    heap_remove(timer);
+  }
+
+  timer->p = PROCESS_CURRENT();
+  heap_insert(timer);
+
+  update_time();
+}
+#else /* ETIMER_WITH_HEAP */
+/*---------------------------------------------------------------------------*/
 static void
 update_time(void)
 {
@@ -79,7 +295,7 @@ update_time(void)
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(etimer_process, ev, data)
 {
-  struct etimer *t, *u;
+  struct etimer *t, *u, *next;
 	
   PROCESS_BEGIN();
 
@@ -109,11 +325,11 @@ PROCESS_THREAD(etimer_process, ev, data)
       continue;
     }
 
-  again:
-    
+    /* Expire all timers in a single pass over the list, and only then
+       compute the next expiration time. */
     u = NULL;
-    
-    for(t = timerlist; t != NULL; t = t->next) {
+    for(t = timerlist; t != NULL; t = next) {
+      next = t->next;
       if(timer_expired(&t->timer)) {
 	if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
 	  
@@ -122,20 +338,19 @@ PROCESS_THREAD(etimer_process, ev, data)
 	     etimer_expired() function. */
 	  t->p = PROCESS_NONE;
 	  if(u != NULL) {
-	    u->next = t->next;
+	    u->next = next;
 	  } else {
-	    timerlist = t->next;
+	    timerlist = next;
 	  }
 	  t->next = NULL;
-	  update_time();
-	  goto again;
+	  continue;
 	} else {
 	  etimer_request_poll();
 	}
       }
       u = t;
     }
-    
+    update_time();
   }
   
   PROCESS_END();
@@ -172,6 +387,7 @@ add_timer(struct etimer *timer)
 
   update_time();
 }
+#endif /* ETIMER_WITH_HEAP */
 /*---------------------------------------------------------------------------*/
 void
 etimer_set(struct etimer *et, clock_time_t interval)
@@ -206,6 +422,12 @@ void
 etimer_adjust(struct etimer *et, int timediff)
 {
   et->timer.start += timediff;
+#if ETIMER_WITH_HEAP
+  if(IN_HEAP(et)) {
+    heap_remove(et);
+    heap_insert(et);
+  }
+#endif /* ETIMER_WITH_HEAP */
   update_time();
 }
 /*---------------------------------------------------------------------------*/
@@ -230,7 +452,11 @@ etimer_start_time(struct etimer *et)
 int
 etimer_pending(void)
 {
+#if ETIMER_WITH_HEAP
+  return timerheap != NULL;
+#else /* ETIMER_WITH_HEAP */
   return timerlist != NULL;
+#endif /* ETIMER_WITH_HEAP */
 }
 /*---------------------------------------------------------------------------*/
 clock_time_t
@@ -242,6 +468,12 @@ etimer_next_expiration_time(void)
 void
 etimer_stop(struct etimer *et)
 {
+#if ETIMER_WITH_HEAP
+  if(IN_HEAP(et)) {
+    heap_remove(et);
+    update_time();
+  }
+#else /* ETIMER_WITH_HEAP */
   struct etimer *t;
 
   /* First check if et is the first event timer on the list. */
@@ -265,6 +497,7 @@ etimer_stop(struct etimer *et)
 
   /* Remove the next pointer from the item to be removed. */
   et->next = NULL;
+#endif /* ETIMER_WITH_HEAP */
   /* Set the timer as expired */
   et->p = PROCESS_NONE;
 }
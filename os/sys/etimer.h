@@ -64,6 +64,29 @@
 
 #include "contiki.h"
 
+/**
+ * \brief Keep pending event timers in a pairing heap
+ *
+ * By default, pending event timers are kept on an unsorted list and
+ * every insertion costs a walk of the whole list. When
+ * ETIMER_CONF_WITH_HEAP is set, the timers are instead kept in an
+ * intrusive pairing heap ordered by expiration time: the next
+ * expiration time is read in constant time, while insertions and
+ * removals cost O(log n) amortized. This is useful on systems with
+ * many concurrent event timers, such as native border routers.
+ *
+ * As with the list, an event timer need not be initialized before it
+ * is set: a timer is known to be in the heap by a marker that points
+ * to the timer itself, which garbage in a reused block of memory does
+ * not. Pending timers must expire within half the range of
+ * clock_time_t of each other.
+ */
+#ifdef ETIMER_CONF_WITH_HEAP
+#define ETIMER_WITH_HEAP ETIMER_CONF_WITH_HEAP
+#else /* ETIMER_CONF_WITH_HEAP */
+#define ETIMER_WITH_HEAP 0
+#endif /* ETIMER_CONF_WITH_HEAP */
+
 /**
  * A timer.
  *
@@ -76,6 +99,11 @@ struct etimer {
   struct timer timer;
   struct etimer *next;
   struct process *p;
+#if ETIMER_WITH_HEAP
+  struct etimer *child;
+  struct etimer *prev;
+  struct etimer *in_heap;
+#endif /* ETIMER_WITH_HEAP */
 };
 
 /**
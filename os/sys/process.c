@@ -47,6 +47,21 @@
 
 #include "contiki.h"
 #include "sys/process.h"
+#if PROCESS_POLL_QUEUE
+#include "sys/critical.h"
+#endif /* PROCESS_POLL_QUEUE */
+#if PROCESS_STATS || PROCESS_PROFILER
+#include "sys/rtimer.h"
+#endif /* PROCESS_STATS || PROCESS_PROFILER */
+#if PROCESS_STATS
+#include <string.h>
+#endif /* PROCESS_STATS */
+#if PROCESS_PROFILER
+#include "services/process-profiler/process-profiler.h"
+#endif /* PROCESS_PROFILER */
+#if PROCESS_GROWABLE_EVENTS
+#include <stdlib.h>
+#endif /* PROCESS_GROWABLE_EVENTS */
 
 /*
  * Pointer to the currently running process structure.
@@ -66,14 +81,45 @@ struct event_data {
 };
 
 static process_num_events_t nevents, fevent;
+
+#if PROCESS_GROWABLE_EVENTS
+/* The queue starts in static memory and moves to the heap as it grows */
+static struct event_data static_events[PROCESS_CONF_NUMEVENTS];
+static struct event_data *events = static_events;
+static process_num_events_t events_size = PROCESS_CONF_NUMEVENTS;
+#define NUMEVENTS events_size
+#else /* PROCESS_GROWABLE_EVENTS */
 static struct event_data events[PROCESS_CONF_NUMEVENTS];
+#define NUMEVENTS PROCESS_CONF_NUMEVENTS
+#endif /* PROCESS_GROWABLE_EVENTS */
 
-#if PROCESS_CONF_STATS
+#if PROCESS_STATS
 process_num_events_t process_maxevents;
-#endif
+uint32_t process_overflows;
+#endif /* PROCESS_STATS */
+
+#if PROCESS_STATS || PROCESS_PROFILER
+/* Time spent in processes called synchronously from the current one */
+static rtimer_clock_t nested_runtime;
+#endif /* PROCESS_STATS || PROCESS_PROFILER */
 
 static volatile unsigned char poll_requested;
 
+#if PROCESS_POLL_QUEUE
+/*
+ * Queues of the processes that requested a poll, one per priority
+ * level. Processes may be appended from interrupt context.
+ */
+static struct process *volatile pollq_head[PROCESS_PRIORITIES];
+static struct process *volatile pollq_tail[PROCESS_PRIORITIES];
+
+#if PROCESS_PRIORITIES > 1
+#define PRIORITY(p) ((p)->priority)
+#else /* PROCESS_PRIORITIES > 1 */
+#define PRIORITY(p) 0
+#endif /* PROCESS_PRIORITIES > 1 */
+#endif /* PROCESS_POLL_QUEUE */
+
 #define PROCESS_STATE_NONE        0
 #define PROCESS_STATE_RUNNING     1
 #define PROCESS_STATE_CALLED      2
@@ -175,6 +221,9 @@ static void
 call_process(struct process *p, process_event_t ev, process_data_t data)
 {
   int ret;
+#if STACK_CHECK_PER_PROCESS
+  int stack_sampled;
+#endif /* STACK_CHECK_PER_PROCESS */
 
 #if DEBUG
   if(p->state == PROCESS_STATE_CALLED) {
@@ -187,7 +236,36 @@ call_process(struct process *p, process_event_t ev, process_data_t data)
     PRINTF("process: calling process '%s' with event %d\n", PROCESS_NAME_STRING(p), ev);
     process_current = p;
     p->state = PROCESS_STATE_CALLED;
+#if STACK_CHECK_PER_PROCESS
+    /* Processes called synchronously are accounted for in the caller */
+    stack_sampled = stack_check_sample_begin();
+#endif /* STACK_CHECK_PER_PROCESS */
+#if PROCESS_STATS || PROCESS_PROFILER
+    {
+      rtimer_clock_t start = RTIMER_NOW();
+      rtimer_clock_t outer = nested_runtime;
+      rtimer_clock_t elapsed;
+
+      nested_runtime = 0;
+      ret = p->thread(&p->pt, ev, data);
+      elapsed = RTIMER_NOW() - start;
+#if PROCESS_STATS
+      p->stats.events++;
+      p->stats.runtime += (rtimer_clock_t)(elapsed - nested_runtime);
+#endif /* PROCESS_STATS */
+#if PROCESS_PROFILER
+      process_profiler_record(p, ev, (rtimer_clock_t)(elapsed - nested_runtime));
+#endif /* PROCESS_PROFILER */
+      nested_runtime = outer + elapsed;
+    }
+#else /* PROCESS_STATS || PROCESS_PROFILER */
     ret = p->thread(&p->pt, ev, data);
+#endif /* PROCESS_STATS || PROCESS_PROFILER */
+#if STACK_CHECK_PER_PROCESS
+    if(stack_sampled) {
+      stack_check_sample_end(&p->stack_peak);
+    }
+#endif /* STACK_CHECK_PER_PROCESS */
     if(ret == PT_EXITED ||
        ret == PT_ENDED ||
        ev == PROCESS_EVENT_EXIT) {
@@ -210,9 +288,10 @@ process_init(void)
   lastevent = PROCESS_EVENT_MAX;
 
   nevents = fevent = 0;
-#if PROCESS_CONF_STATS
+#if PROCESS_STATS
   process_maxevents = 0;
-#endif /* PROCESS_CONF_STATS */
+  process_overflows = 0;
+#endif /* PROCESS_STATS */
 
   process_current = process_list = NULL;
 }
@@ -221,6 +300,40 @@ process_init(void)
  * Call each process' poll handler.
  */
 /*---------------------------------------------------------------------------*/
+#if PROCESS_POLL_QUEUE
+static void
+do_poll(void)
+{
+  struct process *queue[PROCESS_PRIORITIES];
+  struct process *p, *next;
+  int_master_status_t status;
+  int i;
+
+  /* Take over the queued processes. Processes polled from now on are
+     called on the next round. */
+  status = critical_enter();
+  poll_requested = 0;
+  for(i = 0; i < PROCESS_PRIORITIES; i++) {
+    queue[i] = pollq_head[i];
+    pollq_head[i] = pollq_tail[i] = NULL;
+  }
+  critical_exit(status);
+
+  /* Call the processes, highest priority first */
+  for(i = PROCESS_PRIORITIES - 1; i >= 0; i--) {
+    for(p = queue[i]; p != NULL; p = next) {
+      /* The process may poll itself again, which relinks it */
+      next = p->pollnext;
+      p->pollnext = NULL;
+      p->needspoll = 0;
+      if(process_is_running(p)) {
+        p->state = PROCESS_STATE_RUNNING;
+        call_process(p, PROCESS_EVENT_POLL, NULL);
+      }
+    }
+  }
+}
+#else /* PROCESS_POLL_QUEUE */
 static void
 do_poll(void)
 {
@@ -236,6 +349,7 @@ do_poll(void)
     }
   }
 }
+#endif /* PROCESS_POLL_QUEUE */
 /*---------------------------------------------------------------------------*/
 /*
  * Process the next event in the event queue and deliver it to
@@ -268,7 +382,7 @@ do_event(void)
 
     /* Since we have seen the new event, we move pointer upwards
        and decrease the number of events. */
-    fevent = (fevent + 1) % PROCESS_CONF_NUMEVENTS;
+    fevent = (fevent + 1) % NUMEVENTS;
     --nevents;
 
     /* If this is a broadcast event, we deliver it to all events, in
@@ -313,11 +427,60 @@ process_run(void)
 }
 /*---------------------------------------------------------------------------*/
 int
+process_run_batch(unsigned max)
+{
+  do {
+    /* Process poll events before every event. */
+    if(poll_requested) {
+      do_poll();
+    }
+
+    /* Process one event from the queue */
+    do_event();
+  } while(max-- > 1 && nevents > 0);
+
+  return nevents + poll_requested;
+}
+/*---------------------------------------------------------------------------*/
+int
 process_nevents(void)
 {
   return nevents + poll_requested;
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_GROWABLE_EVENTS
+static int
+grow_events(void)
+{
+  struct event_data *larger;
+  process_num_events_t size, i;
+
+  if(events_size >= PROCESS_MAX_NUMEVENTS) {
+    return 0;
+  }
+  size = events_size * 2;
+  if(size > PROCESS_MAX_NUMEVENTS) {
+    size = PROCESS_MAX_NUMEVENTS;
+  }
+  larger = malloc(size * sizeof(struct event_data));
+  if(larger == NULL) {
+    return 0;
+  }
+
+  /* Copy the pending events in order, starting at the new array's head */
+  for(i = 0; i < nevents; i++) {
+    larger[i] = events[(fevent + i) % events_size];
+  }
+  if(events != static_events) {
+    free(events);
+  }
+  events = larger;
+  events_size = size;
+  fevent = 0;
+  return 1;
+}
+#endif /* PROCESS_GROWABLE_EVENTS */
+/*---------------------------------------------------------------------------*/
 int
 process_post(struct process *p, process_event_t ev, process_data_t data)
 {
@@ -332,7 +495,17 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
 	   p == PROCESS_BROADCAST? "<broadcast>": PROCESS_NAME_STRING(p), nevents);
   }
 
-  if(nevents == PROCESS_CONF_NUMEVENTS) {
+  if(nevents == NUMEVENTS
+#if PROCESS_GROWABLE_EVENTS
+     && !grow_events()
+#endif /* PROCESS_GROWABLE_EVENTS */
+     ) {
+#if PROCESS_STATS
+    process_overflows++;
+    if(p != PROCESS_BROADCAST) {
+      p->stats.overflows++;
+    }
+#endif /* PROCESS_STATS */
 #if DEBUG
     if(p == PROCESS_BROADCAST) {
       printf("soft panic: event queue is full when broadcast event %d was posted from %s\n", ev, PROCESS_NAME_STRING(process_current));
@@ -343,17 +516,17 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
     return PROCESS_ERR_FULL;
   }
 
-  snum = (process_num_events_t)(fevent + nevents) % PROCESS_CONF_NUMEVENTS;
+  snum = (process_num_events_t)(fevent + nevents) % NUMEVENTS;
   events[snum].ev = ev;
   events[snum].data = data;
   events[snum].p = p;
   ++nevents;
 
-#if PROCESS_CONF_STATS
+#if PROCESS_STATS
   if(nevents > process_maxevents) {
     process_maxevents = nevents;
   }
-#endif /* PROCESS_CONF_STATS */
+#endif /* PROCESS_STATS */
 
   return PROCESS_ERR_OK;
 }
@@ -373,12 +546,60 @@ process_poll(struct process *p)
   if(p != NULL) {
     if(p->state == PROCESS_STATE_RUNNING ||
        p->state == PROCESS_STATE_CALLED) {
+#if PROCESS_POLL_QUEUE
+      int_master_status_t status;
+
+      status = critical_enter();
+      /* A process is on the queue as long as its poll is pending */
+      if(!p->needspoll) {
+        p->needspoll = 1;
+        p->pollnext = NULL;
+        if(pollq_tail[PRIORITY(p)] != NULL) {
+          pollq_tail[PRIORITY(p)]->pollnext = p;
+        } else {
+          pollq_head[PRIORITY(p)] = p;
+        }
+        pollq_tail[PRIORITY(p)] = p;
+      }
+      poll_requested = 1;
+      critical_exit(status);
+#else /* PROCESS_POLL_QUEUE */
       p->needspoll = 1;
       poll_requested = 1;
+#endif /* PROCESS_POLL_QUEUE */
     }
   }
 }
 /*---------------------------------------------------------------------------*/
+void
+process_set_priority(struct process *p, unsigned char priority)
+{
+#if PROCESS_PRIORITIES > 1
+  p->priority = priority < PROCESS_PRIORITIES ?
+    priority : PROCESS_PRIORITIES - 1;
+#endif /* PROCESS_PRIORITIES > 1 */
+}
+/*---------------------------------------------------------------------------*/
+process_num_events_t
+process_event_queue_size(void)
+{
+  return NUMEVENTS;
+}
+/*---------------------------------------------------------------------------*/
+#if PROCESS_STATS
+void
+process_stats_reset(void)
+{
+  struct process *p;
+
+  process_maxevents = nevents;
+  process_overflows = 0;
+  for(p = process_list; p != NULL; p = p->next) {
+    memset(&p->stats, 0, sizeof(p->stats));
+  }
+}
+#endif /* PROCESS_STATS */
+/*---------------------------------------------------------------------------*/
 int
 process_is_running(struct process *p)
 {
@@ -55,10 +55,30 @@
 
 #include "sys/pt.h"
 #include "sys/cc.h"
+#include "sys/stack-check.h"
 
 typedef unsigned char process_event_t;
 typedef void *        process_data_t;
+
+/**
+ * \brief Grow the event queue when it is full
+ *
+ * When PROCESS_CONF_GROWABLE_EVENTS is set, an event posted to a full
+ * queue doubles the size of the queue, up to PROCESS_MAX_NUMEVENTS
+ * events, instead of being dropped. The queue is then allocated with
+ * malloc(), so this is meant for native builds.
+ */
+#ifdef PROCESS_CONF_GROWABLE_EVENTS
+#define PROCESS_GROWABLE_EVENTS PROCESS_CONF_GROWABLE_EVENTS
+#else /* PROCESS_CONF_GROWABLE_EVENTS */
+#define PROCESS_GROWABLE_EVENTS 0
+#endif /* PROCESS_CONF_GROWABLE_EVENTS */
+
+#if PROCESS_GROWABLE_EVENTS
+typedef unsigned int  process_num_events_t;
+#else /* PROCESS_GROWABLE_EVENTS */
 typedef unsigned char process_num_events_t;
+#endif /* PROCESS_GROWABLE_EVENTS */
 
 /**
  * \name Return values
@@ -88,6 +108,87 @@ typedef unsigned char process_num_events_t;
 #define PROCESS_CONF_NUMEVENTS 32
 #endif /* PROCESS_CONF_NUMEVENTS */
 
+#ifdef PROCESS_CONF_MAX_NUMEVENTS
+#define PROCESS_MAX_NUMEVENTS PROCESS_CONF_MAX_NUMEVENTS
+#else /* PROCESS_CONF_MAX_NUMEVENTS */
+#define PROCESS_MAX_NUMEVENTS 1024
+#endif /* PROCESS_CONF_MAX_NUMEVENTS */
+
+/**
+ * \brief Keep event queue and per-process statistics
+ *
+ * When PROCESS_CONF_STATS is set, the maximum depth of the event
+ * queue and the number of events dropped because the queue was full
+ * are recorded, as well as, for every process, the number of events
+ * it received, the time it ran and the number of events to it that
+ * were dropped. The shell shows them with the process-stats command.
+ */
+#ifdef PROCESS_CONF_STATS
+#define PROCESS_STATS PROCESS_CONF_STATS
+#else /* PROCESS_CONF_STATS */
+#define PROCESS_STATS 0
+#endif /* PROCESS_CONF_STATS */
+
+/**
+ * \brief Number of events processed per turn of the main loop
+ *
+ * The main loops run the system with process_run_batch() and this
+ * value. With the default of 1, a single event is processed before
+ * the platform checks for I/O or goes to sleep.
+ */
+#ifdef PROCESS_CONF_RUN_BATCH
+#define PROCESS_RUN_BATCH PROCESS_CONF_RUN_BATCH
+#else /* PROCESS_CONF_RUN_BATCH */
+#define PROCESS_RUN_BATCH 1
+#endif /* PROCESS_CONF_RUN_BATCH */
+
+/**
+ * \brief Report the time spent in every process call to the profiler
+ *
+ * Set by the process-profiler service (MODULES += os/services/process-profiler).
+ */
+#ifdef PROCESS_CONF_PROFILER
+#define PROCESS_PROFILER PROCESS_CONF_PROFILER
+#else /* PROCESS_CONF_PROFILER */
+#define PROCESS_PROFILER 0
+#endif /* PROCESS_CONF_PROFILER */
+
+/**
+ * \brief Keep the polled processes in a queue
+ *
+ * By default, the whole process list is walked to find the processes
+ * that requested a poll. When PROCESS_CONF_POLL_QUEUE is set, polled
+ * processes are appended to a ready queue instead, so that the cost
+ * of dispatching polls does not grow with the number of processes.
+ */
+#ifdef PROCESS_CONF_POLL_QUEUE
+#define PROCESS_POLL_QUEUE PROCESS_CONF_POLL_QUEUE
+#else /* PROCESS_CONF_POLL_QUEUE */
+#define PROCESS_POLL_QUEUE 0
+#endif /* PROCESS_CONF_POLL_QUEUE */
+
+/**
+ * \brief Number of process priority levels
+ *
+ * With more than one level, polled processes of higher priority are
+ * called first. The priority of a process is set with
+ * process_set_priority(). Requires PROCESS_CONF_POLL_QUEUE.
+ */
+#ifdef PROCESS_CONF_PRIORITIES
+#define PROCESS_PRIORITIES PROCESS_CONF_PRIORITIES
+#else /* PROCESS_CONF_PRIORITIES */
+#define PROCESS_PRIORITIES 1
+#endif /* PROCESS_CONF_PRIORITIES */
+
+#if PROCESS_PRIORITIES > 1 && !PROCESS_POLL_QUEUE
+#error "PROCESS_CONF_PRIORITIES requires PROCESS_CONF_POLL_QUEUE"
+#endif
+
+/** \brief The default priority of a process */
+#define PROCESS_PRIORITY_NORMAL 0
+/** \brief The highest priority, used by the network stack processes */
+#define PROCESS_PRIORITY_HIGH   (PROCESS_PRIORITIES - 1)
+
 #define PROCESS_EVENT_NONE            0x80
 #define PROCESS_EVENT_INIT            0x81
 #define PROCESS_EVENT_POLL            0x82
@@ -312,6 +413,21 @@ static PT_THREAD(process_thread_##name(struct pt *process_pt,	\
 
 /** @} */
 
+#if PROCESS_STATS
+/**
+ * Statistics kept for every process when PROCESS_CONF_STATS is set.
+ */
+struct process_stats {
+  /** Number of events, including polls, delivered to the process */
+  uint32_t events;
+  /** Time spent in the process, in rtimer ticks. The time spent in
+      processes it calls synchronously is not included. */
+  uint32_t runtime;
+  /** Number of events to the process dropped on a full queue */
+  uint16_t overflows;
+};
+#endif /* PROCESS_STATS */
+
 struct process {
   struct process *next;
 #if PROCESS_CONF_NO_PROCESS_NAMES
@@ -323,6 +439,19 @@ struct process {
   PT_THREAD((* thread)(struct pt *, process_event_t, process_data_t));
   struct pt pt;
   unsigned char state, needspoll;
+#if PROCESS_POLL_QUEUE
+  struct process *pollnext;
+#if PROCESS_PRIORITIES > 1
+  unsigned char priority;
+#endif /* PROCESS_PRIORITIES > 1 */
+#endif /* PROCESS_POLL_QUEUE */
+#if PROCESS_STATS
+  struct process_stats stats;
+#endif /* PROCESS_STATS */
+#if STACK_CHECK_PER_PROCESS
+  /** Peak stack usage measured during a call to the process */
+  uint16_t stack_peak;
+#endif /* STACK_CHECK_PER_PROCESS */
 };
 
 /**
@@ -499,6 +628,20 @@ void process_init(void);
  */
 int process_run(void);
 
+/**
+ * Run the system for a batch of events.
+ *
+ * This function is equivalent to calling process_run() up to \a max
+ * times, or until there are no more events waiting in the queue: the
+ * poll handlers are still called before every event. Main loops use
+ * it to drain bursts of events without going through the idle and
+ * I/O handling code after every single event.
+ *
+ * \param max The maximum number of events to process
+ * \return The number of events that are currently waiting in the
+ * event queue.
+ */
+int process_run_batch(unsigned max);
 
 /**
  * Check if a process is running.
@@ -519,6 +662,40 @@ int process_is_running(struct process *p);
  */
 int process_nevents(void);
 
+/**
+ * Set the priority of a process.
+ *
+ * Polled processes of higher priority are called before the others.
+ * Priorities range from PROCESS_PRIORITY_NORMAL to
+ * PROCESS_PRIORITY_HIGH; higher values are capped. Without
+ * PROCESS_CONF_PRIORITIES, this function has no effect.
+ *
+ * \param p The process.
+ * \param priority The priority of the process.
+ */
+void process_set_priority(struct process *p, unsigned char priority);
+
+/**
+ * Size of the event queue.
+ *
+ * \return The number of events the queue can hold. Unless
+ * PROCESS_CONF_GROWABLE_EVENTS is set, this is PROCESS_CONF_NUMEVENTS.
+ */
+process_num_events_t process_event_queue_size(void);
+
+#if PROCESS_STATS
+/** Maximum number of events that were waiting in the queue */
+extern process_num_events_t process_maxevents;
+/** Number of events dropped because the event queue was full */
+extern uint32_t process_overflows;
+
+/**
+ * Reset the event queue statistics and the statistics of all
+ * running processes.
+ */
+void process_stats_reset(void);
+#endif /* PROCESS_STATS */
+
 /** @} */
 
 extern struct process *process_list;
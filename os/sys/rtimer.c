@@ -54,7 +54,32 @@
 #define PRINTF(...)
 #endif
 
+#if RTIMER_MULTIPLE
+#include "sys/critical.h"
+#include <string.h>
+
+/* The pending tasks, ordered by time */
+static struct rtimer *rtimer_queue;
+static struct rtimer_stats stats;
+#else /* RTIMER_MULTIPLE */
 static struct rtimer *next_rtimer;
+#endif /* RTIMER_MULTIPLE */
+
+/*---------------------------------------------------------------------------*/
+static void
+run_task(struct rtimer *t)
+{
+#if STACK_CHECK_PER_PROCESS
+  int stack_sampled = stack_check_sample_begin();
+
+  t->func(t, t->ptr);
+  if(stack_sampled) {
+    stack_check_sample_end(&stack_check_interrupt_peak);
+  }
+#else /* STACK_CHECK_PER_PROCESS */
+  t->func(t, t->ptr);
+#endif /* STACK_CHECK_PER_PROCESS */
+}
 
 /*---------------------------------------------------------------------------*/
 void
@@ -62,6 +87,138 @@ rtimer_init(void)
 {
   rtimer_arch_init();
 }
+#if RTIMER_MULTIPLE
+/*---------------------------------------------------------------------------*/
+/* Schedule the hardware timer for the first task, never in the past.
+   Called with interrupts disabled. */
+static void
+schedule_first(void)
+{
+  rtimer_clock_t now;
+
+  if(rtimer_queue != NULL) {
+    now = RTIMER_NOW();
+    if(RTIMER_CLOCK_LT(rtimer_queue->time, now + RTIMER_GUARD_TIME)) {
+      rtimer_arch_schedule(now + RTIMER_GUARD_TIME);
+    } else {
+      rtimer_arch_schedule(rtimer_queue->time);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Remove a task from the queue. Called with interrupts disabled. */
+static int
+remove_task(struct rtimer *task)
+{
+  struct rtimer **q;
+
+  for(q = &rtimer_queue; *q != NULL; q = &(*q)->next) {
+    if(*q == task) {
+      *q = task->next;
+      task->next = NULL;
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+rtimer_set(struct rtimer *rtimer, rtimer_clock_t time,
+	   rtimer_clock_t duration,
+	   rtimer_callback_t func, void *ptr)
+{
+  struct rtimer **q;
+  int_master_status_t status;
+
+  PRINTF("rtimer_set time %d\n", time);
+
+  status = critical_enter();
+
+  /* Setting a pending task reschedules it */
+  remove_task(rtimer);
+
+  rtimer->func = func;
+  rtimer->ptr = ptr;
+  rtimer->time = time;
+
+  /* Insert after the tasks scheduled for the same time or earlier */
+  for(q = &rtimer_queue;
+      *q != NULL && !RTIMER_CLOCK_LT(time, (*q)->time);
+      q = &(*q)->next);
+  rtimer->next = *q;
+  *q = rtimer;
+
+  if(rtimer_queue == rtimer) {
+    schedule_first();
+  }
+
+  critical_exit(status);
+  return RTIMER_OK;
+}
+/*---------------------------------------------------------------------------*/
+int
+rtimer_cancel(struct rtimer *task)
+{
+  int_master_status_t status;
+  int removed;
+
+  status = critical_enter();
+  removed = remove_task(task);
+  critical_exit(status);
+  return removed;
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_run_next(void)
+{
+  struct rtimer *t;
+  rtimer_clock_t lateness;
+  int_master_status_t status;
+
+  while(1) {
+    status = critical_enter();
+    t = rtimer_queue;
+    if(t == NULL) {
+      critical_exit(status);
+      return;
+    }
+    if(RTIMER_CLOCK_LT(RTIMER_NOW() + RTIMER_GUARD_TIME, t->time)) {
+      /* The timer fired early, or the task was rescheduled */
+      schedule_first();
+      critical_exit(status);
+      return;
+    }
+    rtimer_queue = t->next;
+    t->next = NULL;
+    critical_exit(status);
+
+    /* The task may be due within the guard time */
+    while(RTIMER_CLOCK_LT(RTIMER_NOW(), t->time));
+
+    lateness = RTIMER_NOW() - t->time;
+    stats.runs++;
+    stats.lateness_total += lateness;
+    if(lateness > stats.lateness_max) {
+      stats.lateness_max = lateness;
+    }
+
+    run_task(t);
+  }
+}
+/*---------------------------------------------------------------------------*/
+const struct rtimer_stats *
+rtimer_get_stats(void)
+{
+  return &stats;
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_reset_stats(void)
+{
+  memset(&stats, 0, sizeof(stats));
+}
+/*---------------------------------------------------------------------------*/
+#else /* RTIMER_MULTIPLE */
 /*---------------------------------------------------------------------------*/
 int
 rtimer_set(struct rtimer *rtimer, rtimer_clock_t time,
@@ -97,12 +254,13 @@ rtimer_run_next(void)
   }
   t = next_rtimer;
   next_rtimer = NULL;
-  t->func(t, t->ptr);
+  run_task(t);
   if(next_rtimer != NULL) {
     rtimer_arch_schedule(next_rtimer->time);
   }
   return;
 }
+#endif /* RTIMER_MULTIPLE */
 /*---------------------------------------------------------------------------*/
 
 /** @}*/
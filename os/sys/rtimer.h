@@ -98,6 +98,25 @@ typedef uint64_t rtimer_clock_t;
  */
 void rtimer_init(void);
 
+/**
+ * \brief Allow several pending real-time tasks
+ *
+ * By default, a single real-time task can be pending: setting another
+ * task replaces it. When RTIMER_CONF_MULTIPLE is set, pending tasks
+ * are kept in a queue ordered by time, and the hardware timer is
+ * always scheduled for the first one. Tasks are then run in order of
+ * time, and the time between the scheduled and the actual execution
+ * of each task is recorded, see rtimer_get_stats().
+ *
+ * Pending tasks must be scheduled within half the range of
+ * rtimer_clock_t of each other.
+ */
+#ifdef RTIMER_CONF_MULTIPLE
+#define RTIMER_MULTIPLE RTIMER_CONF_MULTIPLE
+#else /* RTIMER_CONF_MULTIPLE */
+#define RTIMER_MULTIPLE 0
+#endif /* RTIMER_CONF_MULTIPLE */
+
 struct rtimer;
 typedef void (* rtimer_callback_t)(struct rtimer *t, void *ptr);
 
@@ -112,6 +131,9 @@ struct rtimer {
   rtimer_clock_t time;
   rtimer_callback_t func;
   void *ptr;
+#if RTIMER_MULTIPLE
+  struct rtimer *next;
+#endif /* RTIMER_MULTIPLE */
 };
 
 enum {
@@ -138,6 +160,45 @@ enum {
 int rtimer_set(struct rtimer *task, rtimer_clock_t time,
 	       rtimer_clock_t duration, rtimer_callback_t func, void *ptr);
 
+#if RTIMER_MULTIPLE
+/**
+ * \brief      Cancel a pending real-time task.
+ * \param task A pointer to the task
+ * \return     Non-zero if the task was pending, zero otherwise
+ *
+ *             This function is only available with RTIMER_CONF_MULTIPLE.
+ */
+int rtimer_cancel(struct rtimer *task);
+
+/**
+ * \brief Statistics on the execution of real-time tasks
+ *
+ * The lateness of a task is the time between the time it was
+ * scheduled for and the time its callback was called, in rtimer
+ * ticks.
+ */
+struct rtimer_stats {
+  /** Number of tasks that were run */
+  uint32_t runs;
+  /** Sum of the lateness of all tasks */
+  uint32_t lateness_total;
+  /** Largest lateness of a task */
+  rtimer_clock_t lateness_max;
+};
+
+/**
+ * \brief      Get the execution statistics of real-time tasks
+ *
+ *             This function is only available with RTIMER_CONF_MULTIPLE.
+ */
+const struct rtimer_stats *rtimer_get_stats(void);
+
+/**
+ * \brief      Reset the execution statistics of real-time tasks
+ */
+void rtimer_reset_stats(void);
+#endif /* RTIMER_MULTIPLE */
+
 /**
  * \brief      Execute the next real-time task and schedule the next task, if any
  *
@@ -42,6 +42,7 @@
 
 #include "contiki.h"
 #include "sys/stack-check.h"
+#include "sys/int-master.h"
 #include "dev/watchdog.h"
 #include <string.h>
 
@@ -60,6 +61,13 @@ PROCESS(stack_check_process, "Stack check");
 /* The symbol with which the stack memory is initially filled */
 #define STACK_FILL 0xcd
 /*---------------------------------------------------------------------------*/
+/* The maximal usage measured before the fill pattern was restored */
+static uint16_t max_usage;
+static volatile uint8_t sampling;
+#if STACK_CHECK_PER_PROCESS
+uint16_t stack_check_interrupt_peak;
+#endif /* STACK_CHECK_PER_PROCESS */
+/*---------------------------------------------------------------------------*/
 #ifdef STACK_ORIGIN
 /* use the #defined value */
 #define GET_STACK_ORIGIN() STACK_ORIGIN
@@ -91,14 +99,12 @@ stack_check_init(void)
 #endif
 }
 /*---------------------------------------------------------------------------*/
-uint16_t
-stack_check_get_usage(void)
+/* Find the deepest point of the stack that does not hold the fill pattern */
+static uint8_t *
+find_stack_end(void)
 {
   uint8_t *p = &_stack;
 
-  /* Make sure WDT is not triggered */
-  watchdog_periodic();
-
   /* Skip the bytes used after heap; it's 1 byte by default for _stack,
    * more than that means dynamic memory allocation is used somewhere.
    */
@@ -111,9 +117,12 @@ stack_check_get_usage(void)
     p++;
   }
 
-  /* Make sure WDT is not triggered */
-  watchdog_periodic();
-
+  return p;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+usage_of(uint8_t *p)
+{
   if(p >= (uint8_t*)GET_STACK_ORIGIN()) {
     /* This means the stack is screwed. */
     return 0xffff;
@@ -123,6 +132,84 @@ stack_check_get_usage(void)
 }
 /*---------------------------------------------------------------------------*/
 uint16_t
+stack_check_get_usage(void)
+{
+  uint16_t usage;
+
+  /* Make sure WDT is not triggered */
+  watchdog_periodic();
+
+  usage = usage_of(find_stack_end());
+
+  /* Make sure WDT is not triggered */
+  watchdog_periodic();
+
+  /* The fill pattern may have been restored by a measurement */
+  return usage > max_usage ? usage : max_usage;
+}
+/*---------------------------------------------------------------------------*/
+/* Restore the fill pattern from p up to the stack pointer, less the
+   margin. Not inlined, so that its frame is the deepest one in use. */
+static CC_NO_INLINE void
+refill_stack(uint8_t *p)
+{
+  volatile uint8_t top;
+  uint8_t *end;
+
+  end = (uint8_t *)&top - STACK_CHECK_SAMPLE_MARGIN;
+  while(p < end) {
+    *p++ = STACK_FILL;
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+stack_check_sample_begin(void)
+{
+  int_master_status_t status;
+  uint8_t *p;
+  uint16_t usage;
+
+  /* Measurements also start from real-time tasks, in interrupt context */
+  status = int_master_read_and_disable();
+  if(sampling) {
+    int_master_status_set(status);
+    return 0;
+  }
+  sampling = 1;
+  int_master_status_set(status);
+
+  p = find_stack_end();
+  usage = usage_of(p);
+  if(usage > max_usage) {
+    max_usage = usage;
+  }
+
+  /* An interrupt that went deeper than p since has left its trace
+     below p, where the measurement accounts for it. None may leave one
+     where the pattern is being restored, only to have it erased. */
+  status = int_master_read_and_disable();
+  refill_stack(p);
+  int_master_status_set(status);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+stack_check_sample_end(uint16_t *peak)
+{
+  uint16_t usage;
+
+  usage = usage_of(find_stack_end());
+  if(usage > max_usage) {
+    max_usage = usage;
+  }
+  if(peak != NULL && usage > *peak) {
+    *peak = usage;
+  }
+  sampling = 0;
+  return usage;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
 stack_check_get_reserved_size(void)
 {
   return (uint8_t *)GET_STACK_ORIGIN() - &_stack;
@@ -84,6 +84,32 @@
 #define STACK_CHECK_PERIOD (10 * CLOCK_SECOND)
 #endif
 
+/*
+ * The number of bytes just below the stack pointer that a measurement
+ * leaves alone when it restores the fill pattern. They hold the frame
+ * of the loop that restores it, and on ABIs with a red zone, such as
+ * x86-64, data that functions keep below the stack pointer. Interrupts
+ * are disabled meanwhile, so no interrupt frame is pushed there.
+ */
+#ifdef STACK_CHECK_CONF_SAMPLE_MARGIN
+#define STACK_CHECK_SAMPLE_MARGIN STACK_CHECK_CONF_SAMPLE_MARGIN
+#elif defined(__x86_64__)
+#define STACK_CHECK_SAMPLE_MARGIN 160
+#else
+#define STACK_CHECK_SAMPLE_MARGIN 32
+#endif
+
+/*
+ * Measure the peak stack usage of every process call and real-time
+ * task? This costs a scan of the unused stack before and after each
+ * of them.
+ */
+#if STACK_CHECK_ENABLED && defined(STACK_CHECK_CONF_PER_PROCESS)
+#define STACK_CHECK_PER_PROCESS STACK_CHECK_CONF_PER_PROCESS
+#else
+#define STACK_CHECK_PER_PROCESS 0
+#endif
+
 /**
  * \brief      Initialize the stack area with a known pattern
  *
@@ -115,6 +141,34 @@ uint16_t stack_check_get_usage(void);
  */
 uint16_t stack_check_get_reserved_size(void);
 
+/**
+ * \brief      Start measuring the stack usage of a code section
+ * \return     Non-zero if the measurement started, zero if another
+ *             measurement is already in progress
+ *
+ *             This function fills the stack memory used so far below
+ *             the caller with the known pattern again, so that
+ *             stack_check_sample_end() finds the deepest stack usage
+ *             since the call. A measurement started from an interrupt
+ *             handler while another measurement is in progress is
+ *             refused; the usage of the interrupt handler is then
+ *             accounted for in the other measurement.
+ */
+int stack_check_sample_begin(void);
+
+/**
+ * \brief      End a measurement of the stack usage
+ * \param peak A peak usage to update, or NULL
+ * \return     The maximal stack usage since stack_check_sample_begin(),
+ *             counted from the stack origin
+ */
+uint16_t stack_check_sample_end(uint16_t *peak);
+
+#if STACK_CHECK_PER_PROCESS
+/** \brief The peak stack usage measured in real-time tasks */
+extern uint16_t stack_check_interrupt_peak;
+#endif /* STACK_CHECK_PER_PROCESS */
+
 /**
  * \brief      The origin point from which the stack grows (an optional #define)
  *
@@ -36,11 +36,14 @@
 #include "lib/circular-list.h"
 #include "lib/dbl-list.h"
 #include "lib/dbl-circ-list.h"
+#include "lib/hash-map.h"
+#include "lib/ordered-map.h"
 #include "lib/random.h"
 #include "services/unit-test/unit-test.h"
 
 #include <string.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 /*---------------------------------------------------------------------------*/
@@ -55,6 +58,16 @@ typedef struct demo_struct_s {
 #define ELEMENT_COUNT 10
 static demo_struct_t elements[ELEMENT_COUNT];
 /*---------------------------------------------------------------------------*/
+typedef struct keyed_struct_s {
+  struct keyed_struct_s *next;
+  void *hash_next;
+  struct ordered_map_node node;
+  uint16_t key;
+} keyed_struct_t;
+/*---------------------------------------------------------------------------*/
+#define KEYED_COUNT 32
+static keyed_struct_t keyed[KEYED_COUNT];
+/*---------------------------------------------------------------------------*/
 void
 print_test_report(const unit_test_t *utp)
 {
@@ -1024,6 +1037,202 @@ UNIT_TEST(test_cdll)
   UNIT_TEST_END();
 }
 /*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_hash_map, "Hash map");
+UNIT_TEST(test_hash_map)
+{
+  keyed_struct_t *item, duplicate;
+  uint16_t key;
+  int i, count;
+
+  LIST(lst);
+  HASH_MAP(map, 8, keyed_struct_t, hash_next, key);
+
+  UNIT_TEST_BEGIN();
+
+  memset(keyed, 0, sizeof(keyed));
+  list_init(lst);
+  hash_map_init(map);
+
+  /* Starts from empty */
+  key = 0;
+  UNIT_TEST_ASSERT(hash_map_length(map) == 0);
+  UNIT_TEST_ASSERT(hash_map_head(map) == NULL);
+  UNIT_TEST_ASSERT(hash_map_lookup(map, &key) == NULL);
+
+  /* Items are in a list and in the map at the same time */
+  for(i = 0; i < KEYED_COUNT; i++) {
+    keyed[i].key = i * 37;
+    list_add(lst, &keyed[i]);
+    UNIT_TEST_ASSERT(hash_map_add(map, &keyed[i]) == true);
+  }
+  UNIT_TEST_ASSERT(hash_map_length(map) == KEYED_COUNT);
+  UNIT_TEST_ASSERT(list_length(lst) == KEYED_COUNT);
+
+  /* Keys are unique */
+  duplicate.key = keyed[5].key;
+  UNIT_TEST_ASSERT(hash_map_add(map, &duplicate) == false);
+  UNIT_TEST_ASSERT(hash_map_length(map) == KEYED_COUNT);
+
+  /* Lookups */
+  for(i = 0; i < KEYED_COUNT; i++) {
+    key = i * 37;
+    UNIT_TEST_ASSERT(hash_map_lookup(map, &key) == &keyed[i]);
+  }
+  key = 1;
+  UNIT_TEST_ASSERT(hash_map_lookup(map, &key) == NULL);
+
+  /* Iteration visits every item once */
+  count = 0;
+  for(item = hash_map_head(map); item != NULL;
+      item = hash_map_item_next(map, item)) {
+    UNIT_TEST_ASSERT(item->key % 37 == 0);
+    count++;
+  }
+  UNIT_TEST_ASSERT(count == KEYED_COUNT);
+
+  /* Remove every other item */
+  for(i = 0; i < KEYED_COUNT; i += 2) {
+    UNIT_TEST_ASSERT(hash_map_remove(map, &keyed[i]) == true);
+    UNIT_TEST_ASSERT(hash_map_remove(map, &keyed[i]) == false);
+  }
+  UNIT_TEST_ASSERT(hash_map_length(map) == KEYED_COUNT / 2);
+  for(i = 0; i < KEYED_COUNT; i++) {
+    key = i * 37;
+    UNIT_TEST_ASSERT(hash_map_lookup(map, &key) ==
+                     (i % 2 == 0 ? NULL : &keyed[i]));
+  }
+
+  /* The list is not affected */
+  UNIT_TEST_ASSERT(list_length(lst) == KEYED_COUNT);
+
+  /* Ends empty */
+  hash_map_init(map);
+  UNIT_TEST_ASSERT(hash_map_length(map) == 0);
+  UNIT_TEST_ASSERT(hash_map_head(map) == NULL);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+static int
+compare_uint16(const void *key1, const void *key2)
+{
+  uint16_t k1, k2;
+
+  memcpy(&k1, key1, sizeof(k1));
+  memcpy(&k2, key2, sizeof(k2));
+  return k1 < k2 ? -1 : k1 > k2;
+}
+/*---------------------------------------------------------------------------*/
+/* Check the links, order and balance of a subtree. Returns its height,
+   or -1 if it is not a valid AVL tree. */
+static int
+check_subtree(struct ordered_map_node *n, struct ordered_map_node *parent)
+{
+  keyed_struct_t *item;
+  int left, right;
+
+  if(n == NULL) {
+    return 0;
+  }
+  item = (keyed_struct_t *)((uint8_t *)n - offsetof(keyed_struct_t, node));
+  left = check_subtree(n->left, n);
+  right = check_subtree(n->right, n);
+  if(left < 0 || right < 0 || n->parent != parent ||
+     n->balance != right - left || right - left > 1 || left - right > 1) {
+    return -1;
+  }
+  if((n->left != NULL &&
+      ((keyed_struct_t *)((uint8_t *)n->left - offsetof(keyed_struct_t, node)))->key >= item->key) ||
+     (n->right != NULL &&
+      ((keyed_struct_t *)((uint8_t *)n->right - offsetof(keyed_struct_t, node)))->key <= item->key)) {
+    return -1;
+  }
+  return 1 + (left > right ? left : right);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_ordered_map, "Ordered map");
+UNIT_TEST(test_ordered_map)
+{
+  keyed_struct_t *item, duplicate;
+  uint16_t key;
+  int i, count;
+
+  ORDERED_MAP(map, keyed_struct_t, node, key, compare_uint16);
+
+  UNIT_TEST_BEGIN();
+
+  memset(keyed, 0, sizeof(keyed));
+  ordered_map_init(map);
+
+  /* Starts from empty */
+  key = 0;
+  UNIT_TEST_ASSERT(ordered_map_length(map) == 0);
+  UNIT_TEST_ASSERT(ordered_map_head(map) == NULL);
+  UNIT_TEST_ASSERT(ordered_map_tail(map) == NULL);
+  UNIT_TEST_ASSERT(ordered_map_lookup(map, &key) == NULL);
+  UNIT_TEST_ASSERT(ordered_map_lower_bound(map, &key) == NULL);
+
+  /* Add keys 0, 3, ..., 93 in a scrambled order. The tree must stay
+     balanced. */
+  for(i = 0; i < KEYED_COUNT; i++) {
+    keyed[i].key = (i * 7) % KEYED_COUNT * 3;
+    UNIT_TEST_ASSERT(ordered_map_add(map, &keyed[i]) == true);
+    UNIT_TEST_ASSERT(check_subtree(map->root, NULL) >= 0);
+  }
+  UNIT_TEST_ASSERT(ordered_map_length(map) == KEYED_COUNT);
+  /* 32 items fit in a tree of height 7 at most */
+  UNIT_TEST_ASSERT(check_subtree(map->root, NULL) <= 7);
+
+  /* Keys are unique */
+  duplicate.key = keyed[5].key;
+  UNIT_TEST_ASSERT(ordered_map_add(map, &duplicate) == false);
+  UNIT_TEST_ASSERT(ordered_map_length(map) == KEYED_COUNT);
+
+  /* Items are visited in order, both ways */
+  count = 0;
+  for(item = ordered_map_head(map); item != NULL;
+      item = ordered_map_item_next(map, item)) {
+    UNIT_TEST_ASSERT(item->key == count * 3);
+    count++;
+  }
+  UNIT_TEST_ASSERT(count == KEYED_COUNT);
+  for(item = ordered_map_tail(map); item != NULL;
+      item = ordered_map_item_prev(map, item)) {
+    count--;
+    UNIT_TEST_ASSERT(item->key == count * 3);
+  }
+  UNIT_TEST_ASSERT(count == 0);
+
+  /* Lookups */
+  key = 42;
+  item = ordered_map_lookup(map, &key);
+  UNIT_TEST_ASSERT(item != NULL && item->key == 42);
+  key = 43;
+  UNIT_TEST_ASSERT(ordered_map_lookup(map, &key) == NULL);
+  item = ordered_map_lower_bound(map, &key);
+  UNIT_TEST_ASSERT(item != NULL && item->key == 45);
+  key = 93;
+  item = ordered_map_lower_bound(map, &key);
+  UNIT_TEST_ASSERT(item != NULL && item->key == 93);
+  key = 94;
+  UNIT_TEST_ASSERT(ordered_map_lower_bound(map, &key) == NULL);
+
+  /* Remove all items in another order. The tree must stay balanced. */
+  for(i = 0; i < KEYED_COUNT; i++) {
+    item = &keyed[(i * 5) % KEYED_COUNT];
+    ordered_map_remove(map, item);
+    UNIT_TEST_ASSERT(ordered_map_lookup(map, &item->key) == NULL);
+    UNIT_TEST_ASSERT(check_subtree(map->root, NULL) >= 0);
+    UNIT_TEST_ASSERT(ordered_map_length(map) == KEYED_COUNT - i - 1);
+  }
+
+  /* Ends empty */
+  UNIT_TEST_ASSERT(ordered_map_head(map) == NULL);
+  UNIT_TEST_ASSERT(ordered_map_tail(map) == NULL);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(data_structure_test_process, ev, data)
 {
   PROCESS_BEGIN();
@@ -1039,6 +1248,8 @@ PROCESS_THREAD(data_structure_test_process, ev, data)
   UNIT_TEST_RUN(test_csll);
   UNIT_TEST_RUN(test_dll);
   UNIT_TEST_RUN(test_cdll);
+  UNIT_TEST_RUN(test_hash_map);
+  UNIT_TEST_RUN(test_ordered_map);
 
   printf("=check-me= DONE\n");
 
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Test of concurrent real-time tasks: tasks must run in order
+ *         of time, no later than a bound, and can be rescheduled and
+ *         cancelled while other tasks are pending or running.
+ */
+
+#include "contiki.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+/*---------------------------------------------------------------------------*/
+#define MS(ms) ((rtimer_clock_t)((uint64_t)(ms) * RTIMER_SECOND / 1000))
+/* Upper bound on the lateness of a task. Native processes are at the
+   mercy of the host scheduler. */
+#if CONTIKI_TARGET_NATIVE
+#define MAX_LATENESS MS(100)
+#else /* CONTIKI_TARGET_NATIVE */
+#define MAX_LATENESS MS(20)
+#endif /* CONTIKI_TARGET_NATIVE */
+
+#define NUM_TASKS 8
+#define PERIODIC_RUNS 5
+#define TICKS 100
+
+static const uint8_t offsets[NUM_TASKS] = { 50, 10, 80, 30, 70, 20, 60, 40 };
+static struct rtimer tasks[NUM_TASKS];
+static struct rtimer periodic;
+static int order[NUM_TASKS];
+static int runs;
+static int periodic_runs;
+static struct rtimer ticker;
+static volatile int ticks;
+static rtimer_clock_t max_lateness;
+static int failed;
+/*---------------------------------------------------------------------------*/
+PROCESS(test_process, "rtimer multiplexing test");
+AUTOSTART_PROCESSES(&test_process);
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr)
+{
+  printf("=check-me= %s - %s\n", cond ? "SUCCEEDED" : "FAILED", descr);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+task_callback(struct rtimer *t, void *ptr)
+{
+  rtimer_clock_t lateness = RTIMER_NOW() - t->time;
+
+  if(lateness > max_lateness) {
+    max_lateness = lateness;
+  }
+  if(runs < NUM_TASKS) {
+    order[runs] = (int)(intptr_t)ptr;
+  }
+  runs++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+periodic_callback(struct rtimer *t, void *ptr)
+{
+  task_callback(t, ptr);
+  if(++periodic_runs < PERIODIC_RUNS) {
+    rtimer_set(t, t->time + MS(15), 0, periodic_callback, ptr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+ticker_callback(struct rtimer *t, void *ptr)
+{
+  int i = ticks % NUM_TASKS;
+
+  /* Move one of the tasks that the process is setting, as a MAC layer
+     would reschedule a slot */
+  rtimer_set(&tasks[i], t->time + MS(200 + offsets[i]), 0,
+             task_callback, (void *)(intptr_t)i);
+  if(++ticks < TICKS) {
+    rtimer_set(t, t->time + MS(1), 0, ticker_callback, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+reset(void)
+{
+  runs = 0;
+  max_lateness = 0;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static struct etimer et;
+  static rtimer_clock_t now;
+  static int i;
+  int in_order;
+
+  PROCESS_BEGIN();
+
+  /* Tasks set in any order run in order of time */
+  reset();
+  rtimer_reset_stats();
+  now = RTIMER_NOW();
+  for(i = 0; i < NUM_TASKS; i++) {
+    rtimer_set(&tasks[i], now + MS(offsets[i]), 0, task_callback,
+               (void *)(intptr_t)i);
+  }
+  etimer_set(&et, CLOCK_SECOND / 2);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+  in_order = runs == NUM_TASKS;
+  for(i = 1; in_order && i < NUM_TASKS; i++) {
+    in_order = offsets[order[i - 1]] < offsets[order[i]];
+  }
+  check(in_order, "tasks run in order");
+  check(max_lateness <= MAX_LATENESS, "tasks run on time");
+  check(rtimer_get_stats()->runs == NUM_TASKS, "runs counted");
+  check(rtimer_get_stats()->lateness_max >= max_lateness, "lateness recorded");
+  printf("Lateness: max %lu, average %lu ticks (%lu ticks per second)\n",
+         (unsigned long)rtimer_get_stats()->lateness_max,
+         (unsigned long)(rtimer_get_stats()->lateness_total / NUM_TASKS),
+         (unsigned long)RTIMER_SECOND);
+
+  /* Cancelled and rescheduled tasks */
+  reset();
+  now = RTIMER_NOW();
+  rtimer_set(&tasks[0], now + MS(20), 0, task_callback, (void *)0);
+  rtimer_set(&tasks[1], now + MS(30), 0, task_callback, (void *)1);
+  rtimer_set(&tasks[2], now + MS(40), 0, task_callback, (void *)2);
+  check(rtimer_cancel(&tasks[1]), "pending task cancelled");
+  check(!rtimer_cancel(&tasks[1]), "task no longer pending");
+  rtimer_set(&tasks[0], now + MS(50), 0, task_callback, (void *)0);
+  etimer_set(&et, CLOCK_SECOND / 2);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  check(runs == 2 && order[0] == 2 && order[1] == 0,
+        "rescheduled task run once, cancelled task not run");
+
+  /* A periodic task interleaved with one-shot tasks */
+  reset();
+  periodic_runs = 0;
+  now = RTIMER_NOW();
+  rtimer_set(&periodic, now + MS(10), 0, periodic_callback, (void *)-1);
+  rtimer_set(&tasks[0], now + MS(32), 0, task_callback, (void *)0);
+  rtimer_set(&tasks[1], now + MS(47), 0, task_callback, (void *)1);
+  etimer_set(&et, CLOCK_SECOND / 2);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  check(periodic_runs == PERIODIC_RUNS && runs == PERIODIC_RUNS + 2,
+        "periodic and one-shot tasks all run");
+  check(order[1] == -1 && order[2] == 0 && order[3] == -1 && order[4] == 1,
+        "periodic and one-shot tasks interleaved");
+  check(max_lateness <= MAX_LATENESS, "periodic task run on time");
+
+  /* Tasks set and cancelled by a process while another task keeps
+     firing and moving them: the queue must not be corrupted by a task
+     running in the middle of a change */
+  ticks = 0;
+  now = RTIMER_NOW();
+  rtimer_set(&ticker, now + MS(1), 0, ticker_callback, NULL);
+  while(ticks < TICKS && RTIMER_NOW() - now < MS(1000)) {
+    for(i = 0; i < NUM_TASKS; i++) {
+      rtimer_set(&tasks[i], RTIMER_NOW() + MS(100 + offsets[i]), 0,
+                 task_callback, (void *)(intptr_t)i);
+    }
+    for(i = 0; i < NUM_TASKS; i += 2) {
+      rtimer_cancel(&tasks[i]);
+    }
+  }
+  check(ticks == TICKS && !rtimer_cancel(&ticker),
+        "firing task run while tasks were set");
+
+  /* Every task is then in the queue once at most */
+  reset();
+  now = RTIMER_NOW();
+  for(i = 0; i < NUM_TASKS; i++) {
+    rtimer_set(&tasks[i], now + MS(offsets[i]), 0, task_callback,
+               (void *)(intptr_t)i);
+  }
+  etimer_set(&et, CLOCK_SECOND / 2);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  in_order = runs == NUM_TASKS;
+  for(i = 1; in_order && i < NUM_TASKS; i++) {
+    in_order = offsets[order[i - 1]] < offsets[order[i]];
+  }
+  check(in_order, "tasks set while another fired run once, in order");
+
+  printf("=check-me= %s\n", failed ? "FAILED" : "DONE");
+#if CONTIKI_TARGET_NATIVE
+  exit(0);
+#endif /* CONTIKI_TARGET_NATIVE */
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,42 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+
+# Benchmark code directory
+CODE_DIR=$CONTIKI/tests/08-native-runs/code-etimer-bench/
+CODE=etimer-bench
+
+rm -f $CODE.log
+
+# Run the benchmark once per event timer backend
+for DEFINES in ETIMER_CONF_WITH_HEAP=0 ETIMER_CONF_WITH_HEAP=1; do
+  echo "Building and running $CODE with $DEFINES"
+  make -C $CODE_DIR clean > /dev/null 2>&1
+  make -C $CODE_DIR TARGET=native DEFINES=$DEFINES >> make.log 2>> make.err
+  timeout 30 $CODE_DIR/$CODE.native >> $CODE.log 2>> $CODE.err
+done
+make -C $CODE_DIR clean > /dev/null 2>&1
+
+if grep -q "=check-me= FAILED" $CODE.log || \
+   [ $(grep -c "=check-me= DONE" $CODE.log) -ne 2 ] ; then
+  echo "==== make.log ====" ; cat make.log;
+  echo "==== make.err ====" ; cat make.err;
+  echo "==== $CODE.log ====" ; cat $CODE.log;
+  echo "==== $CODE.err ====" ; cat $CODE.err;
+
+  printf "%-32s TEST FAIL\n" "$CODE" | tee $CODE.testlog;
+else
+  grep "etimer-bench:\|backend" $CODE.log
+  printf "%-32s TEST OK\n" "$CODE" | tee $CODE.testlog;
+fi
+
+rm make.log
+rm make.err
+rm $CODE.log
+rm $CODE.err
+
+# We do not want Make to stop -> Return 0
+# The Makefile will check if a log contains FAIL at the end
+exit 0
@@ -0,0 +1,36 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+
+# Example code directory
+CODE_DIR=$CONTIKI/tests/07-simulation-base/code-rtimer-multiplex/
+CODE=test-rtimer-multiplex
+
+# Starting Contiki-NG native node, which exits when done
+echo "Running native node"
+make -C $CODE_DIR TARGET=native > make.log 2> make.err
+timeout 30 $CODE_DIR/$CODE.native > $CODE.log 2> $CODE.err
+
+if grep -q "=check-me= FAILED" $CODE.log || \
+   ! grep -q "=check-me= DONE" $CODE.log ; then
+  echo "==== make.log ====" ; cat make.log;
+  echo "==== make.err ====" ; cat make.err;
+  echo "==== $CODE.log ====" ; cat $CODE.log;
+  echo "==== $CODE.err ====" ; cat $CODE.err;
+
+  printf "%-32s TEST FAIL\n" "$CODE" | tee $CODE.testlog;
+else
+  grep "Lateness" $CODE.log
+  printf "%-32s TEST OK\n" "$CODE" | tee $CODE.testlog;
+fi
+
+rm make.log
+rm make.err
+rm $CODE.log
+rm $CODE.err
+
+# We do not want Make to stop -> Return 0
+# The Makefile will check if a log contains FAIL at the end
+exit 0
@@ -0,0 +1,42 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+
+# Benchmark code directory
+CODE_DIR=$CONTIKI/tests/08-native-runs/code-memb-bench/
+CODE=memb-bench
+
+rm -f $CODE.log
+
+# Run the benchmark with both allocators
+for DEFINES in MEMB_CONF_WITH_FREE_LIST=0 MEMB_CONF_WITH_FREE_LIST=1; do
+  echo "Building and running $CODE with $DEFINES"
+  make -C $CODE_DIR clean > /dev/null 2>&1
+  make -C $CODE_DIR TARGET=native DEFINES=$DEFINES >> make.log 2>> make.err
+  timeout 30 $CODE_DIR/$CODE.native >> $CODE.log 2>> $CODE.err
+done
+make -C $CODE_DIR clean > /dev/null 2>&1
+
+if grep -q "=check-me= FAILED" $CODE.log || \
+   [ $(grep -c "=check-me= DONE" $CODE.log) -ne 2 ] ; then
+  echo "==== make.log ====" ; cat make.log;
+  echo "==== make.err ====" ; cat make.err;
+  echo "==== $CODE.log ====" ; cat $CODE.log;
+  echo "==== $CODE.err ====" ; cat $CODE.err;
+
+  printf "%-32s TEST FAIL\n" "$CODE" | tee $CODE.testlog;
+else
+  grep "memb-bench:\|allocator" $CODE.log
+  printf "%-32s TEST OK\n" "$CODE" | tee $CODE.testlog;
+fi
+
+rm make.log
+rm make.err
+rm $CODE.log
+rm $CODE.err
+
+# We do not want Make to stop -> Return 0
+# The Makefile will check if a log contains FAIL at the end
+exit 0
@@ -0,0 +1,45 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+
+# Test code directory
+CODE_DIR=$CONTIKI/tests/08-native-runs/code-sr-forwarding/
+CODE=sr-forwarding
+
+rm -f $CODE.log
+
+# Run the benchmark with the plain and the hashed node lookup, and with
+# cached source routing headers
+for DEFINES in UIP_SR_CONF_HASH_BUCKETS=0 \
+               UIP_SR_CONF_HASH_BUCKETS=256 \
+               UIP_SR_CONF_HASH_BUCKETS=256,UIP_SR_CONF_SRH_CACHE_SIZE=1024; do
+  echo "Building and running $CODE with $DEFINES"
+  make -C $CODE_DIR clean > /dev/null 2>&1
+  make -C $CODE_DIR TARGET=native DEFINES=$DEFINES >> make.log 2>> make.err
+  timeout 60 $CODE_DIR/$CODE.native >> $CODE.log 2>> $CODE.err
+done
+make -C $CODE_DIR clean > /dev/null 2>&1
+
+if grep -q "=check-me= FAILED" $CODE.log || \
+   [ $(grep -c "=check-me= DONE" $CODE.log) -ne 3 ] ; then
+  echo "==== make.log ====" ; cat make.log;
+  echo "==== make.err ====" ; cat make.err;
+  echo "==== $CODE.log ====" ; cat $CODE.log;
+  echo "==== $CODE.err ====" ; cat $CODE.err;
+
+  printf "%-32s TEST FAIL\n" "$CODE" | tee $CODE.testlog;
+else
+  grep "sr-forwarding:" $CODE.log
+  printf "%-32s TEST OK\n" "$CODE" | tee $CODE.testlog;
+fi
+
+rm make.log
+rm make.err
+rm $CODE.log
+rm $CODE.err
+
+# We do not want Make to stop -> Return 0
+# The Makefile will check if a log contains FAIL at the end
+exit 0
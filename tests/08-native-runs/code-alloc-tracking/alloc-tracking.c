@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Test of the allocation tracking: MEMB pools, including the
+ *         queuebuf pools, and the heap are exhausted, and their peak
+ *         usage, failures and the caller of the last failure are
+ *         checked.
+ */
+
+#include "contiki.h"
+#include "lib/memb.h"
+#include "lib/heapmem.h"
+#include "net/queuebuf.h"
+#include "services/mem-stats/mem-stats.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#define POOL_SIZE 4
+#define NUM_ALLOCS 6
+
+struct block {
+  uint32_t data[4];
+};
+
+MEMB(test_pool, struct block, POOL_SIZE);
+
+static struct block *blocks[NUM_ALLOCS];
+static struct queuebuf *qbufs[QUEUEBUF_NUM + 1];
+static int failed;
+/*---------------------------------------------------------------------------*/
+PROCESS(alloc_tracking_process, "Allocation tracking test");
+AUTOSTART_PROCESSES(&alloc_tracking_process);
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr)
+{
+  printf("=check-me= %s - %s\n", cond ? "SUCCEEDED" : "FAILED", descr);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The callers of the failing allocations are small functions, so that
+   a return address into them is easy to recognize. */
+static int
+called_from(void *caller, void (*func)(void))
+{
+  return (char *)caller > (char *)func &&
+    (char *)caller < (char *)func + 256;
+}
+/*---------------------------------------------------------------------------*/
+static __attribute__((noinline)) void
+alloc_blocks(void)
+{
+  int i;
+
+  for(i = 0; i < NUM_ALLOCS; i++) {
+    blocks[i] = memb_alloc(&test_pool);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static __attribute__((noinline)) void
+alloc_queuebufs(void)
+{
+  int i;
+
+  for(i = 0; i < QUEUEBUF_NUM + 1; i++) {
+    qbufs[i] = queuebuf_new_from_packetbuf();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static __attribute__((noinline)) void
+alloc_heap(void)
+{
+  blocks[0] = heapmem_alloc(2 * HEAPMEM_CONF_ARENA_SIZE);
+}
+/*---------------------------------------------------------------------------*/
+static struct memb *
+find_pool(const char *name)
+{
+  struct memb *m;
+
+  for(m = memb_registry_head(); m != NULL; m = memb_registry_next(m)) {
+    if(!strcmp(m->pool_name, name)) {
+      return m;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_memb(void)
+{
+  struct memb *m;
+  int i;
+
+  alloc_blocks();
+  m = find_pool("test_pool");
+  check(m == &test_pool, "pool registered on first allocation");
+  check(test_pool.used == POOL_SIZE && test_pool.used_max == POOL_SIZE,
+        "pool usage counted");
+  check(test_pool.failures == NUM_ALLOCS - POOL_SIZE, "failures counted");
+  check(called_from(test_pool.failure_caller, alloc_blocks),
+        "failure caller recorded");
+
+  for(i = 0; i < POOL_SIZE / 2; i++) {
+    memb_free(&test_pool, blocks[i]);
+  }
+  check(test_pool.used == POOL_SIZE / 2 && test_pool.used_max == POOL_SIZE,
+        "peak usage kept after free");
+
+  memb_stats_reset();
+  check(test_pool.used_max == POOL_SIZE / 2 && test_pool.failures == 0 &&
+        test_pool.failure_caller == NULL, "statistics reset");
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_queuebuf(void)
+{
+  struct memb *m;
+  int i;
+
+  queuebuf_init();
+  packetbuf_clear();
+  packetbuf_set_datalen(32);
+  alloc_queuebufs();
+
+  m = find_pool("bufmem");
+  check(m != NULL, "queuebuf pool registered");
+  if(m != NULL) {
+    check(m->used_max == QUEUEBUF_NUM && m->failures == 1,
+          "queuebuf usage counted");
+    check(called_from(m->failure_caller, alloc_queuebufs),
+          "queuebuf failure charged to its caller");
+  }
+  for(i = 0; i < QUEUEBUF_NUM; i++) {
+    queuebuf_free(qbufs[i]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_heapmem(void)
+{
+  heapmem_stats_t stats;
+  void *ptr;
+
+  ptr = heapmem_alloc(100);
+  heapmem_free(ptr);
+  alloc_heap();
+  heapmem_stats(&stats);
+  check(blocks[0] == NULL && stats.alloc_failures == 1,
+        "heap failure counted");
+  check(stats.footprint_max >= 100, "heap peak footprint kept");
+  check(called_from(stats.failure_caller, alloc_heap),
+        "heap failure caller recorded");
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(alloc_tracking_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  test_memb();
+  test_queuebuf();
+  test_heapmem();
+  mem_stats_log();
+
+  printf("=check-me= %s\n", failed ? "FAILED" : "DONE");
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+
+/**
+ * \file
+ *         Benchmark of the callback timer backends. Measures the cost
+ *         of setting, resetting, stopping and expiring 16, 128 and 1000
+ *         concurrent callback timers, and checks that callbacks are
+ *         called in expiration order, that a callback can re-arm its
+ *         own timer and that stopped timers are not called.
+ */
+
+#include "contiki.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define MAX_TIMERS 1000
+#define EXPIRE_SPREAD 16
+#define REARMS 5
+
+static struct ctimer timers[MAX_TIMERS];
+static struct etimer et;
+static const int sizes[] = { 16, 128, 1000 };
+static int failed;
+static int fired, in_order, rearms;
+static char called[MAX_TIMERS];
+static clock_time_t last;
+/*---------------------------------------------------------------------------*/
+PROCESS(ctimer_bench_process, "Ctimer benchmark");
+AUTOSTART_PROCESSES(&ctimer_bench_process);
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr, int n)
+{
+  printf("=check-me= %s - %s (n=%d)\n", cond ? "SUCCEEDED" : "FAILED", descr, n);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+busy_wait(clock_time_t ticks)
+{
+  clock_time_t end;
+
+  end = clock_time() + ticks;
+  while((long)(clock_time() - end) < 0);
+}
+/*---------------------------------------------------------------------------*/
+static void
+record(void *ptr)
+{
+  struct ctimer *c = ptr;
+
+  if(fired > 0 && (long)(etimer_expiration_time(&c->etimer) - last) < 0) {
+    in_order = 0;
+  }
+  last = etimer_expiration_time(&c->etimer);
+  called[c - timers] = 1;
+  fired++;
+  process_poll(&ctimer_bench_process);
+}
+/*---------------------------------------------------------------------------*/
+static void
+rearm(void *ptr)
+{
+  struct ctimer *c = ptr;
+
+  if(++rearms < REARMS) {
+    ctimer_set(c, 0, rearm, c);
+  }
+  process_poll(&ctimer_bench_process);
+}
+/*---------------------------------------------------------------------------*/
+static void
+stop_next(void *ptr)
+{
+  /* Both timers are due: the second one must not be called */
+  ctimer_stop(&timers[1]);
+  record(ptr);
+}
+/*---------------------------------------------------------------------------*/
+/* A timer in a reused block of memory, which still holds a copy of a
+   pending timer, must not be taken for that timer */
+static void
+test_reused_memory(void)
+{
+  struct ctimer *reused;
+  int i;
+
+  for(i = 0; i < 10; i++) {
+    ctimer_set(&timers[i], CLOCK_SECOND + i, record, &timers[i]);
+  }
+  reused = malloc(sizeof(struct ctimer));
+  memcpy(reused, &timers[5], sizeof(struct ctimer));
+  ctimer_stop(reused);
+  free(reused);
+
+  for(i = 0; i < 10; i++) {
+    if(i != 5) {
+      ctimer_stop(&timers[i]);
+    }
+  }
+  check(!ctimer_expired(&timers[5]) &&
+        ctimer_next_expiration_time() ==
+        etimer_expiration_time(&timers[5].etimer),
+        "timer in reused memory", 10);
+  ctimer_stop(&timers[5]);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(ctimer_bench_process, ev, data)
+{
+  static int s, n, i;
+  static uint64_t start, set_ns, reset_ns, stop_ns, expire_ns;
+
+  PROCESS_BEGIN();
+
+  printf("Ctimer backend: %s\n", CTIMER_WITH_HEAP ? "heap" : "etimers");
+
+  if(CTIMER_WITH_HEAP) {
+    test_reused_memory();
+  }
+
+  /* A callback re-arming its own timer is called again later */
+  rearms = 0;
+  ctimer_set(&timers[0], 0, rearm, &timers[0]);
+  while(rearms < REARMS) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+  }
+  check(ctimer_expired(&timers[0]), "timer re-armed from its callback",
+        REARMS);
+
+  /* Stopping pending timers, before they are due and once they are
+     due, from the callback of another timer */
+  memset(called, 0, sizeof(called));
+  ctimer_set(&timers[0], 1, stop_next, &timers[0]);
+  ctimer_set(&timers[1], 2, record, &timers[1]);
+  ctimer_set(&timers[2], 1, record, &timers[2]);
+  ctimer_set(&timers[3], 3, record, &timers[3]);
+  ctimer_stop(&timers[2]);
+  check(ctimer_expired(&timers[2]) && !ctimer_expired(&timers[3]),
+        "pending timer stopped", 4);
+  busy_wait(3);
+  while(!called[0] || !called[3]) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+  }
+  /* Leave time for a wrongly called timer to be noticed */
+  etimer_set(&et, 2);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  check(!called[2] && ctimer_next_expiration_time() == 0,
+        "stopped timer not called", 4);
+  if(CTIMER_WITH_HEAP) {
+    /* Each etimer posts its own event, in no particular order, so the
+       other backend may call timers[1] before timers[0] */
+    check(!called[1], "due timer stopped from a callback", 4);
+  }
+
+  for(s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    n = sizes[s];
+
+    /* Insertion and removal of timers that do not expire */
+    start = now_ns();
+    for(i = 0; i < n; i++) {
+      ctimer_set(&timers[i], CLOCK_SECOND + random_rand() % CLOCK_SECOND,
+                 record, &timers[i]);
+    }
+    set_ns = now_ns() - start;
+
+    /* Setting pending timers again moves them within the backend */
+    start = now_ns();
+    for(i = 0; i < n; i++) {
+      ctimer_set(&timers[i], CLOCK_SECOND + random_rand() % CLOCK_SECOND,
+                 record, &timers[i]);
+    }
+    reset_ns = now_ns() - start;
+
+    start = now_ns();
+    for(i = 0; i < n; i += 2) {
+      ctimer_stop(&timers[i]);
+    }
+    for(i = 1; i < n; i += 2) {
+      ctimer_stop(&timers[i]);
+    }
+    stop_ns = now_ns() - start;
+    for(i = 0; i < n && ctimer_expired(&timers[i]); i++);
+    check(i == n, "all timers stopped", n);
+
+    /* Expiration of a burst of timers. Busy-wait until all timers are
+       due so that the measurement does not include idle time. */
+    for(i = 0; i < n; i++) {
+      ctimer_set(&timers[i], random_rand() % EXPIRE_SPREAD,
+                 record, &timers[i]);
+    }
+    busy_wait(EXPIRE_SPREAD + 1);
+
+    start = now_ns();
+    fired = 0;
+    in_order = 1;
+    while(fired < n) {
+      PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+    }
+    expire_ns = now_ns() - start;
+
+    for(i = 0; i < n && ctimer_expired(&timers[i]); i++);
+    check(i == n, "all timers expired", n);
+    if(CTIMER_WITH_HEAP) {
+      check(in_order, "timers expired in order", n);
+    }
+
+    printf("ctimer-bench: n %4d set %6lu ns/op reset %6lu ns/op "
+           "stop %6lu ns/op expire %6lu ns/op\n", n,
+           (unsigned long)(set_ns / n), (unsigned long)(reset_ns / n),
+           (unsigned long)(stop_ns / n), (unsigned long)(expire_ns / n));
+  }
+
+  printf("=check-me= %s\n", failed ? "FAILED" : "DONE");
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
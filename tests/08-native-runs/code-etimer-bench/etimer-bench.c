@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark of the event timer backends. Measures the cost of
+ *         setting, resetting, stopping and expiring 10, 100 and 1000
+ *         concurrent event timers, and checks that all timers expire,
+ *         in expiration order when the heap backend is used.
+ */
+
+#include "contiki.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define MAX_TIMERS 1000
+#define EXPIRE_SPREAD 16
+
+static struct etimer timers[MAX_TIMERS];
+static const int sizes[] = { 10, 100, 1000 };
+static int failed;
+/*---------------------------------------------------------------------------*/
+PROCESS(etimer_bench_process, "Etimer benchmark");
+AUTOSTART_PROCESSES(&etimer_bench_process);
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr, int n)
+{
+  printf("=check-me= %s - %s (n=%d)\n", cond ? "SUCCEEDED" : "FAILED", descr, n);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* A timer in a reused block of memory, which still holds a copy of a
+   pending timer, must not be taken for that timer */
+static void
+test_reused_memory(void)
+{
+  struct etimer *reused;
+  int i;
+
+  for(i = 0; i < 10; i++) {
+    etimer_set(&timers[i], CLOCK_SECOND + i);
+  }
+  reused = malloc(sizeof(struct etimer));
+  memcpy(reused, &timers[5], sizeof(struct etimer));
+  etimer_set(reused, CLOCK_SECOND / 2);
+  etimer_stop(reused);
+  free(reused);
+
+  /* The copied timer is still the one to expire once the others are
+     stopped */
+  for(i = 0; i < 10; i++) {
+    if(i != 5) {
+      etimer_stop(&timers[i]);
+    }
+  }
+  check(etimer_pending() &&
+        etimer_next_expiration_time() == etimer_expiration_time(&timers[5]),
+        "timer in reused memory", 10);
+  etimer_stop(&timers[5]);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(etimer_bench_process, ev, data)
+{
+  static int s, n, i, received, in_order;
+  static uint64_t start, set_ns, reset_ns, stop_ns, expire_ns;
+  static clock_time_t last, wait;
+  struct etimer *et;
+
+  PROCESS_BEGIN();
+
+  printf("Etimer backend: %s\n", ETIMER_WITH_HEAP ? "heap" : "list");
+
+  test_reused_memory();
+
+  for(s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    n = sizes[s];
+
+    /* Insertion and removal of timers that do not expire */
+    start = now_ns();
+    for(i = 0; i < n; i++) {
+      etimer_set(&timers[i], CLOCK_SECOND + random_rand() % CLOCK_SECOND);
+    }
+    set_ns = now_ns() - start;
+
+    /* Setting pending timers again moves them within the backend */
+    start = now_ns();
+    for(i = 0; i < n; i++) {
+      etimer_set(&timers[i], CLOCK_SECOND + random_rand() % CLOCK_SECOND);
+    }
+    reset_ns = now_ns() - start;
+
+    start = now_ns();
+    for(i = 0; i < n; i += 2) {
+      etimer_stop(&timers[i]);
+    }
+    for(i = 1; i < n; i += 2) {
+      etimer_stop(&timers[i]);
+    }
+    stop_ns = now_ns() - start;
+    check(!etimer_pending(), "all timers stopped", n);
+
+    /* Expiration of a burst of timers. Busy-wait until all timers are
+       due so that the measurement does not include idle time. */
+    for(i = 0; i < n; i++) {
+      etimer_set(&timers[i], random_rand() % EXPIRE_SPREAD);
+    }
+    wait = clock_time() + EXPIRE_SPREAD + 1;
+    while((long)(clock_time() - wait) < 0);
+
+    start = now_ns();
+    received = 0;
+    in_order = 1;
+    last = 0;
+    while(received < n) {
+      PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER);
+      et = data;
+      if(received > 0 &&
+         (long)(etimer_expiration_time(et) - last) < 0) {
+        in_order = 0;
+      }
+      last = etimer_expiration_time(et);
+      received++;
+    }
+    expire_ns = now_ns() - start;
+
+    for(i = 0; i < n && etimer_expired(&timers[i]); i++);
+    check(i == n && !etimer_pending(), "all timers expired", n);
+    if(ETIMER_WITH_HEAP) {
+      check(in_order, "timers expired in order", n);
+    }
+
+    printf("etimer-bench: n %4d set %6lu ns/op reset %6lu ns/op "
+           "stop %6lu ns/op expire %6lu ns/op\n", n,
+           (unsigned long)(set_ns / n), (unsigned long)(reset_ns / n),
+           (unsigned long)(stop_ns / n), (unsigned long)(expire_ns / n));
+  }
+
+  printf("=check-me= %s\n", failed ? "FAILED" : "DONE");
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Event storm benchmark of the main loop. Tokens are passed
+ *         around a ring of processes as events, and the throughput of
+ *         the native main loop is measured. Every process also polls a
+ *         monitor process, to check that polls are still handled
+ *         between every event when events are processed in batches.
+ */
+
+#include "contiki.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define RELAYS 8
+#define TOKENS 8
+#define TOTAL_EVENTS 20000
+
+static struct process relays[RELAYS];
+static unsigned long delivered;
+static unsigned long poll_requested_at;
+static unsigned long max_poll_lag;
+static int poll_pending;
+static uint64_t start_time;
+/*---------------------------------------------------------------------------*/
+PROCESS(event_storm_process, "Event storm");
+PROCESS(relay_process, "Relay");
+PROCESS(monitor_process, "Monitor");
+AUTOSTART_PROCESSES(&event_storm_process);
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+done(void)
+{
+  uint64_t elapsed = now_ns() - start_time;
+
+  printf("event-storm: batch %3u: %lu events in %lu us, %lu events/s\n",
+         PROCESS_RUN_BATCH, delivered, (unsigned long)(elapsed / 1000),
+         (unsigned long)(delivered * 1000000000ull / elapsed));
+  printf("=check-me= %s - polls handled between events (max lag %lu)\n",
+         max_poll_lag <= 1 ? "SUCCEEDED" : "FAILED", max_poll_lag);
+  printf("=check-me= DONE\n");
+  exit(0);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(monitor_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD();
+    if(ev == PROCESS_EVENT_POLL) {
+      if(delivered - poll_requested_at > max_poll_lag) {
+        max_poll_lag = delivered - poll_requested_at;
+      }
+      poll_pending = 0;
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(relay_process, ev, data)
+{
+  struct process *next;
+
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD();
+    if(ev == PROCESS_EVENT_CONTINUE) {
+      if(++delivered == TOTAL_EVENTS) {
+        done();
+      }
+      if(!poll_pending) {
+        poll_pending = 1;
+        poll_requested_at = delivered;
+        process_poll(&monitor_process);
+      }
+      next = PROCESS_CURRENT() == &relays[RELAYS - 1] ?
+        &relays[0] : PROCESS_CURRENT() + 1;
+      process_post(next, PROCESS_EVENT_CONTINUE, NULL);
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(event_storm_process, ev, data)
+{
+  static int i;
+
+  PROCESS_BEGIN();
+
+  process_start(&monitor_process, NULL);
+  for(i = 0; i < RELAYS; i++) {
+    relays[i] = relay_process;
+    process_start(&relays[i], NULL);
+  }
+  PROCESS_PAUSE();
+
+  start_time = now_ns();
+  for(i = 0; i < TOKENS; i++) {
+    process_post(&relays[i % RELAYS], PROCESS_EVENT_CONTINUE, NULL);
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
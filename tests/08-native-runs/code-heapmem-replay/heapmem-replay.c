@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Replay benchmark of the heapmem allocator. Replays traces of
+ *         heapmem_alloc(), heapmem_realloc() and heapmem_free() calls,
+ *         checks that the allocated memory is never corrupted, and
+ *         reports the cost of the calls and the fragmentation of the
+ *         heap.
+ *
+ *         Traces are read from the files given on the command line,
+ *         one call per line:
+ *           a <slot> <size>    allocate an object in a slot
+ *           r <slot> <size>    reallocate the object of a slot
+ *           f <slot>           free the object of a slot
+ *         Without arguments, built-in traces that mimic the buffer
+ *         usage of MQTT and LWM2M are replayed.
+ */
+
+#include "contiki.h"
+#include "lib/heapmem.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define MAX_OPS 100000
+#define MAX_SLOTS 256
+
+struct op {
+  char type;
+  uint8_t slot;
+  uint16_t size;
+};
+
+static struct op ops[MAX_OPS];
+static int num_ops;
+
+static uint8_t *slots[MAX_SLOTS];
+static uint16_t sizes[MAX_SLOTS];
+static int failed;
+
+extern int contiki_argc;
+extern char **contiki_argv;
+/*---------------------------------------------------------------------------*/
+PROCESS(heapmem_replay_process, "heapmem replay");
+AUTOSTART_PROCESSES(&heapmem_replay_process);
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr, const char *trace)
+{
+  printf("=check-me= %s - %s (%s)\n", cond ? "SUCCEEDED" : "FAILED", descr, trace);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_op(char type, int slot, int size)
+{
+  if(num_ops < MAX_OPS) {
+    ops[num_ops].type = type;
+    ops[num_ops].slot = slot;
+    ops[num_ops].size = size;
+    num_ops++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+rand_range(int min, int max)
+{
+  return min + random_rand() % (max - min + 1);
+}
+/*---------------------------------------------------------------------------*/
+/* MQTT-like: long-lived connection state, and publish messages whose
+   topic and payload buffers live for a few messages. */
+static void
+make_mqtt_trace(void)
+{
+  int i, slot;
+
+  num_ops = 0;
+  for(i = 0; i < 8; i++) {
+    add_op('a', i, rand_range(64, 160));
+  }
+  for(i = 0; i < 20000; i++) {
+    slot = 8 + 2 * (i % 16);
+    if(i >= 16) {
+      add_op('f', slot, 0);
+      add_op('f', slot + 1, 0);
+    }
+    add_op('a', slot, rand_range(16, 48));
+    add_op('a', slot + 1, rand_range(32, 512));
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* LWM2M-like: many small, long-lived objects and instances, and
+   message buffers that grow by reallocation while being built. */
+static void
+make_lwm2m_trace(void)
+{
+  int i, j, slot;
+  int size;
+
+  num_ops = 0;
+  for(i = 0; i < 200; i++) {
+    add_op('a', i, rand_range(8, 40));
+  }
+  for(i = 0; i < 4000; i++) {
+    /* Replace an object now and then */
+    slot = random_rand() % 200;
+    add_op('f', slot, 0);
+    add_op('a', slot, rand_range(8, 40));
+
+    /* Build a message */
+    slot = 200 + i % 4;
+    if(i >= 4) {
+      add_op('f', slot, 0);
+    }
+    size = 32;
+    add_op('a', slot, size);
+    for(j = rand_range(0, 10); j > 0; j--) {
+      size += 32;
+      add_op('r', slot, size);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Random sizes and lifetimes */
+static void
+make_random_trace(void)
+{
+  int i, slot;
+
+  num_ops = 0;
+  for(i = 0; i < 60000; i++) {
+    slot = random_rand() % 128;
+    if(slots[slot] == NULL && random_rand() % 2) {
+      add_op('a', slot, rand_range(1, 300));
+      slots[slot] = (uint8_t *)1;
+    } else if(slots[slot] != NULL) {
+      add_op('f', slot, 0);
+      slots[slot] = NULL;
+    }
+  }
+  memset(slots, 0, sizeof(slots));
+}
+/*---------------------------------------------------------------------------*/
+static int
+load_trace(const char *filename)
+{
+  FILE *f;
+  char line[64];
+  char type;
+  int slot, size;
+
+  f = fopen(filename, "r");
+  if(f == NULL) {
+    return 0;
+  }
+  num_ops = 0;
+  while(fgets(line, sizeof(line), f) != NULL) {
+    size = 0;
+    if(sscanf(line, " %c %d %d", &type, &slot, &size) >= 2 &&
+       (type == 'a' || type == 'r' || type == 'f') &&
+       slot >= 0 && slot < MAX_SLOTS) {
+      add_op(type, slot, size);
+    }
+  }
+  fclose(f);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+contents_ok(int slot, int size)
+{
+  int i;
+
+  for(i = 0; i < size; i++) {
+    if(slots[slot][i] != (uint8_t)(slot + i)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill(int slot, int from, int to)
+{
+  int i;
+
+  for(i = from; i < to; i++) {
+    slots[slot][i] = (uint8_t)(slot + i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+replay(const char *name)
+{
+  int i, slot, intact, failures;
+  uint8_t *p;
+  uint64_t start, elapsed;
+  heapmem_stats_t stats;
+  size_t frag_max, largest_min;
+
+  intact = 1;
+  failures = 0;
+  elapsed = 0;
+  frag_max = 0;
+  largest_min = HEAPMEM_CONF_ARENA_SIZE;
+
+  for(i = 0; i < num_ops; i++) {
+    slot = ops[i].slot;
+    switch(ops[i].type) {
+    case 'a':
+      if(slots[slot] != NULL) {
+        break;
+      }
+      start = now_ns();
+      p = heapmem_alloc(ops[i].size);
+      elapsed += now_ns() - start;
+      if(p == NULL) {
+        failures++;
+        break;
+      }
+      slots[slot] = p;
+      sizes[slot] = ops[i].size;
+      fill(slot, 0, sizes[slot]);
+      break;
+    case 'r':
+      if(slots[slot] == NULL) {
+        break;
+      }
+      start = now_ns();
+      p = heapmem_realloc(slots[slot], ops[i].size);
+      elapsed += now_ns() - start;
+      if(p == NULL) {
+        failures++;
+        break;
+      }
+      slots[slot] = p;
+      if(!contents_ok(slot, MIN(sizes[slot], ops[i].size))) {
+        intact = 0;
+      }
+      fill(slot, 0, ops[i].size);
+      sizes[slot] = ops[i].size;
+      break;
+    case 'f':
+      if(slots[slot] == NULL) {
+        break;
+      }
+      if(!contents_ok(slot, sizes[slot])) {
+        intact = 0;
+      }
+      start = now_ns();
+      heapmem_free(slots[slot]);
+      elapsed += now_ns() - start;
+      slots[slot] = NULL;
+      break;
+    }
+
+    if(i % 64 == 0) {
+      heapmem_stats(&stats);
+      if(stats.fragmentation > frag_max) {
+        frag_max = stats.fragmentation;
+      }
+      if(stats.largest_free < largest_min) {
+        largest_min = stats.largest_free;
+      }
+    }
+  }
+
+  heapmem_stats(&stats);
+  printf("heapmem-replay: %-8s %6d calls, %4lu ns/call, %d failures, "
+         "steps avg %lu max %lu, fragmentation %lu/%lu permil, "
+         "largest free %lu min %lu\n",
+         name, num_ops, (unsigned long)(elapsed / (num_ops ? num_ops : 1)),
+         failures,
+         (unsigned long)(stats.alloc_steps / (stats.allocations ? stats.allocations : 1)),
+         (unsigned long)stats.alloc_steps_max,
+         (unsigned long)stats.fragmentation, (unsigned long)frag_max,
+         (unsigned long)stats.largest_free, (unsigned long)largest_min);
+
+  /* Free what is left: the heap must then be empty */
+  for(slot = 0; slot < MAX_SLOTS; slot++) {
+    if(slots[slot] != NULL) {
+      if(!contents_ok(slot, sizes[slot])) {
+        intact = 0;
+      }
+      heapmem_free(slots[slot]);
+      slots[slot] = NULL;
+    }
+  }
+  check(intact, "memory contents intact", name);
+  heapmem_stats(&stats);
+  check(stats.footprint == 0 && stats.chunks == 0 && stats.allocated == 0 &&
+        stats.available == HEAPMEM_CONF_ARENA_SIZE,
+        "heap empty after freeing everything", name);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(heapmem_replay_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  if(contiki_argc > 1) {
+    for(i = 1; i < contiki_argc; i++) {
+      if(load_trace(contiki_argv[i])) {
+        replay(contiki_argv[i]);
+      } else {
+        check(0, "trace file readable", contiki_argv[i]);
+      }
+    }
+  } else {
+    make_mqtt_trace();
+    replay("mqtt");
+    make_lwm2m_trace();
+    replay("lwm2m");
+    make_random_trace();
+    replay("random");
+  }
+
+  printf("=check-me= DONE\n");
+  exit(failed);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Fuzz test and throughput benchmark of the Internet checksum.
+ *         Checksums of random buffers, at every alignment and length, and
+ *         of ICMPv6 packets are compared with a byte-at-a-time reference.
+ *         Reports the CPU cycles (or nanoseconds) per checksum for
+ *         several payload sizes, for uIP and for the reference.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-icmp6.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define FUZZ_ROUNDS 200000
+#define FUZZ_MAX_LEN 300
+#define PACKET_ROUNDS 10000
+#define REPEATS 5
+
+#define UIP_IP_BUF ((struct uip_ip_hdr *)&uip_buf[UIP_LLH_LEN])
+
+static const int sizes[] = { 16, 64, 256, 1024 };
+static uint8_t data[1024 + 8];
+static volatile uint16_t sink;
+static int failed;
+/*---------------------------------------------------------------------------*/
+PROCESS(internet_chksum_process, "Internet checksum test");
+AUTOSTART_PROCESSES(&internet_chksum_process);
+/*---------------------------------------------------------------------------*/
+#if defined(__i386__) || defined(__x86_64__)
+#define UNIT "cycles"
+#define now() __builtin_ia32_rdtsc()
+#else
+#define UNIT "ns"
+static uint64_t
+now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+#endif
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr, int n)
+{
+  printf("=check-me= %s - %s (n=%d)\n", cond ? "SUCCEEDED" : "FAILED", descr, n);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* One 16-bit word at a time, in network byte order, as in RFC 1071 */
+static uint16_t
+reference_chksum(uint16_t sum, const uint8_t *p, int len)
+{
+  uint32_t acc = sum;
+
+  for(; len > 1; p += 2, len -= 2) {
+    acc += (p[0] << 8) | p[1];
+    acc = (acc & 0xffff) + (acc >> 16);
+  }
+  if(len == 1) {
+    acc += p[0] << 8;
+    acc = (acc & 0xffff) + (acc >> 16);
+  }
+  return acc;
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill(uint8_t *p, int len, int pattern)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    switch(pattern) {
+    case 0:
+      p[i] = rand();
+      break;
+    case 1:
+      /* Sums that wrap around many times */
+      p[i] = 0xff;
+      break;
+    default:
+      /* Sums that stay at zero */
+      p[i] = 0;
+      break;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+fuzz_buffers(void)
+{
+  int i, offset, len;
+  uint16_t expected;
+
+  for(i = 0; i < FUZZ_ROUNDS; i++) {
+    offset = rand() % 8;
+    len = rand() % (FUZZ_MAX_LEN + 1);
+    fill(data + offset, len, i % 16 == 0 ? 1 : i % 16 == 1 ? 2 : 0);
+    expected = uip_htons(reference_chksum(0, data + offset, len));
+    if(uip_chksum((uint16_t *)(data + offset), len) != expected) {
+      printf("mismatch: offset %d, len %d\n", offset, len);
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* An echo request in uip_buf, with a random payload */
+static void
+build_icmp6_packet(int payload_len)
+{
+  int len = UIP_ICMPH_LEN + 4 + payload_len;
+
+  memset(uip_buf, 0, UIP_IPH_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = UIP_PROTO_ICMP6;
+  UIP_IP_BUF->ttl = 64;
+  UIP_IP_BUF->len[0] = len >> 8;
+  UIP_IP_BUF->len[1] = len & 0xff;
+  fill((uint8_t *)&UIP_IP_BUF->srcipaddr, 2 * sizeof(uip_ipaddr_t), 0);
+  fill(&uip_buf[UIP_LLH_LEN + UIP_IPH_LEN], len, 0);
+  uip_buf[UIP_LLH_LEN + UIP_IPH_LEN] = ICMP6_ECHO_REQUEST;
+  uip_ext_len = 0;
+  uip_len = UIP_IPH_LEN + len;
+}
+/*---------------------------------------------------------------------------*/
+static int
+fuzz_packets(void)
+{
+  int i, len;
+  uint16_t sum;
+
+  for(i = 0; i < PACKET_ROUNDS; i++) {
+    len = rand() % (UIP_BUFSIZE - UIP_LLH_LEN - UIP_IPH_LEN - UIP_ICMPH_LEN - 4);
+    build_icmp6_packet(len);
+    len += UIP_ICMPH_LEN + 4;
+    /* The pseudo-header, then the ICMPv6 message */
+    sum = reference_chksum(len + UIP_PROTO_ICMP6,
+                           (uint8_t *)&UIP_IP_BUF->srcipaddr,
+                           2 * sizeof(uip_ipaddr_t));
+    sum = reference_chksum(sum, &uip_buf[UIP_LLH_LEN + UIP_IPH_LEN], len);
+    sum = uip_htons(sum == 0 ? 0xffff : sum);
+    if(uip_icmp6chksum() != sum) {
+      printf("mismatch: ICMPv6 length %d\n", len);
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench_chksum(int len)
+{
+  uint64_t start, elapsed, best_uip, best_ref;
+  int i, r;
+  int rounds = 1000000 / len;
+
+  fill(data, len, 0);
+  best_uip = best_ref = UINT64_MAX;
+  for(r = 0; r < REPEATS; r++) {
+    start = now();
+    for(i = 0; i < rounds; i++) {
+      sink = uip_chksum((uint16_t *)data, len);
+    }
+    elapsed = now() - start;
+    best_uip = MIN(best_uip, elapsed);
+
+    start = now();
+    for(i = 0; i < rounds; i++) {
+      sink = reference_chksum(0, data, len);
+    }
+    elapsed = now() - start;
+    best_ref = MIN(best_ref, elapsed);
+  }
+
+  printf("internet-chksum: %d bytes, %lu " UNIT " per checksum (reference %lu)\n",
+         len, (unsigned long)(best_uip / rounds),
+         (unsigned long)(best_ref / rounds));
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(internet_chksum_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  srand(1);
+  check(fuzz_buffers(), "buffer checksums match", FUZZ_ROUNDS);
+  check(fuzz_packets(), "ICMPv6 checksums match", PACKET_ROUNDS);
+
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    bench_chksum(sizes[i]);
+  }
+
+  printf("=check-me= DONE\n");
+  exit(failed);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
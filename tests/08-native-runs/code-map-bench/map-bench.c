@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark of the hash map and ordered map libraries against
+ *         a list, with 16-byte keys such as IPv6 addresses. Reports
+ *         the time per lookup and per removal and insertion, and
+ *         checks the results, as well as the balance of the ordered
+ *         map after random insertions and removals.
+ */
+
+#include "contiki.h"
+#include "lib/list.h"
+#include "lib/hash-map.h"
+#include "lib/ordered-map.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define MAX_ITEMS 1024
+#define LOOKUPS 200000
+#define CHURNS 50000
+
+struct item {
+  struct item *next;
+  void *hash_next;
+  struct ordered_map_node node;
+  uint8_t key[16];
+};
+
+static struct item items[MAX_ITEMS];
+static uint16_t order[MAX_ITEMS];
+static int failed;
+
+LIST(item_list);
+HASH_MAP(hash16, 16, struct item, hash_next, key);
+HASH_MAP(hash64, 64, struct item, hash_next, key);
+HASH_MAP(hash256, 256, struct item, hash_next, key);
+HASH_MAP(hash1024, 1024, struct item, hash_next, key);
+ORDERED_MAP(tree, struct item, node, key, NULL);
+/*---------------------------------------------------------------------------*/
+PROCESS(map_bench_process, "map benchmark");
+AUTOSTART_PROCESSES(&map_bench_process);
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr, int n)
+{
+  printf("=check-me= %s - %s (n=%d)\n", cond ? "SUCCEEDED" : "FAILED", descr, n);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Keys share a common prefix, like addresses in a subnet */
+static void
+set_key(struct item *it, int i)
+{
+  memset(it->key, 0, sizeof(it->key));
+  it->key[0] = 0xfd;
+  it->key[14] = (i * 7919) >> 8;
+  it->key[15] = i * 7919;
+}
+/*---------------------------------------------------------------------------*/
+static struct item *
+list_lookup(const uint8_t *key)
+{
+  struct item *it;
+
+  for(it = list_head(item_list); it != NULL; it = list_item_next(it)) {
+    if(memcmp(it->key, key, sizeof(it->key)) == 0) {
+      return it;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Check the links, order and balance of a subtree. Returns its height,
+   or -1 if it is not a valid AVL tree. */
+static int
+check_subtree(struct ordered_map_node *n, struct ordered_map_node *parent)
+{
+  int left, right;
+
+  if(n == NULL) {
+    return 0;
+  }
+  left = check_subtree(n->left, n);
+  right = check_subtree(n->right, n);
+  if(left < 0 || right < 0 || n->parent != parent ||
+     n->balance != right - left || abs(right - left) > 1) {
+    return -1;
+  }
+  return 1 + (left > right ? left : right);
+}
+/*---------------------------------------------------------------------------*/
+static void
+shuffle(int n)
+{
+  int i, j;
+  uint16_t tmp;
+
+  for(i = 0; i < n; i++) {
+    order[i] = i;
+  }
+  for(i = n - 1; i > 0; i--) {
+    j = random_rand() % (i + 1);
+    tmp = order[i];
+    order[i] = order[j];
+    order[j] = tmp;
+  }
+}
+/*---------------------------------------------------------------------------*/
+enum { LIST_KIND, HASH_KIND, TREE_KIND };
+static const char *kind_names[] = { "list", "hash-map", "ordered-map" };
+
+static struct item *
+lookup(int kind, hash_map_t hash, const uint8_t *key)
+{
+  switch(kind) {
+  case LIST_KIND:
+    return list_lookup(key);
+  case HASH_KIND:
+    return hash_map_lookup(hash, key);
+  default:
+    return ordered_map_lookup(tree, key);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+add(int kind, hash_map_t hash, struct item *it)
+{
+  switch(kind) {
+  case LIST_KIND:
+    list_add(item_list, it);
+    break;
+  case HASH_KIND:
+    hash_map_add(hash, it);
+    break;
+  default:
+    ordered_map_add(tree, it);
+    break;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_item(int kind, hash_map_t hash, struct item *it)
+{
+  switch(kind) {
+  case LIST_KIND:
+    list_remove(item_list, it);
+    break;
+  case HASH_KIND:
+    hash_map_remove(hash, it);
+    break;
+  default:
+    ordered_map_remove(tree, it);
+    break;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench(int kind, int n, hash_map_t hash)
+{
+  uint64_t start, lookup_ns, churn_ns;
+  struct item *it;
+  int i, ok;
+
+  list_init(item_list);
+  hash_map_init(hash);
+  ordered_map_init(tree);
+  for(i = 0; i < n; i++) {
+    set_key(&items[i], i);
+    add(kind, hash, &items[i]);
+  }
+
+  /* Lookups in random order */
+  shuffle(n);
+  ok = 1;
+  start = now_ns();
+  for(i = 0; i < LOOKUPS; i++) {
+    it = &items[order[i % n]];
+    ok &= lookup(kind, hash, it->key) == it;
+  }
+  lookup_ns = now_ns() - start;
+
+  /* Remove and add back random items */
+  start = now_ns();
+  for(i = 0; i < CHURNS; i++) {
+    it = &items[order[(i * 13) % n]];
+    remove_item(kind, hash, it);
+    add(kind, hash, it);
+  }
+  churn_ns = now_ns() - start;
+
+  printf("map-bench: %-11s %4d items: %5lu ns per lookup, %5lu ns per removal and insertion\n",
+         kind_names[kind], n, (unsigned long)(lookup_ns / LOOKUPS),
+         (unsigned long)(churn_ns / CHURNS));
+  check(ok, "lookups", n);
+}
+/*---------------------------------------------------------------------------*/
+static void
+stress_tree(void)
+{
+  static uint8_t in_tree[MAX_ITEMS];
+  struct item *it, *prev;
+  int i, n, count, ok, height;
+
+  ordered_map_init(tree);
+  memset(in_tree, 0, sizeof(in_tree));
+  for(i = 0; i < MAX_ITEMS; i++) {
+    set_key(&items[i], i);
+  }
+
+  /* Random insertions and removals, with the tree checked regularly */
+  ok = 1;
+  n = 0;
+  for(i = 0; i < 100000; i++) {
+    int j = random_rand() % MAX_ITEMS;
+    if(in_tree[j]) {
+      ordered_map_remove(tree, &items[j]);
+      n--;
+    } else {
+      ok &= ordered_map_add(tree, &items[j]);
+      n++;
+    }
+    in_tree[j] = !in_tree[j];
+    if(i % 1000 == 0) {
+      ok &= check_subtree(tree->root, NULL) >= 0;
+    }
+  }
+  height = check_subtree(tree->root, NULL);
+  ok &= height >= 0 && ordered_map_length(tree) == n;
+
+  /* The items come out in key order */
+  count = 0;
+  prev = NULL;
+  for(it = ordered_map_head(tree); it != NULL;
+      it = ordered_map_item_next(tree, it)) {
+    ok &= prev == NULL || memcmp(prev->key, it->key, sizeof(it->key)) < 0;
+    prev = it;
+    count++;
+  }
+  ok &= count == n;
+
+  printf("map-bench: ordered-map of %d items has height %d\n", n, height);
+  check(ok, "ordered map stays balanced and sorted", n);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(map_bench_process, ev, data)
+{
+  static const struct {
+    int n;
+    hash_map_t *hash;
+  } sizes[] = { { 16, &hash16 }, { 64, &hash64 }, { 256, &hash256 }, { 1024, &hash1024 } };
+  int i, kind;
+
+  PROCESS_BEGIN();
+
+  random_init(1);
+
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    for(kind = LIST_KIND; kind <= TREE_KIND; kind++) {
+      bench(kind, sizes[i].n, *sizes[i].hash);
+    }
+  }
+  stress_tree();
+
+  printf("=check-me= DONE\n");
+  exit(failed);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
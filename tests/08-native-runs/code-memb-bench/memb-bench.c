@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark of the memb block allocator. Measures the cost of
+ *         memb_alloc() and memb_free() on pools of 8 to 512 blocks,
+ *         when filling and draining a pool and when allocating and
+ *         freeing random blocks of a half-full pool.
+ */
+
+#include "contiki.h"
+#include "lib/memb.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define MAX_BLOCKS 512
+#define FILL_REPETITIONS 200
+#define CHURN_OPERATIONS 100000
+
+struct block {
+  uint32_t data[4];
+};
+
+MEMB(pool8, struct block, 8);
+MEMB(pool16, struct block, 16);
+MEMB(pool32, struct block, 32);
+MEMB(pool64, struct block, 64);
+MEMB(pool128, struct block, 128);
+MEMB(pool256, struct block, 256);
+MEMB(pool512, struct block, 512);
+
+static struct memb *const pools[] = {
+  &pool8, &pool16, &pool32, &pool64, &pool128, &pool256, &pool512
+};
+static struct block *blocks[MAX_BLOCKS];
+static int failed;
+/*---------------------------------------------------------------------------*/
+PROCESS(memb_bench_process, "memb benchmark");
+AUTOSTART_PROCESSES(&memb_bench_process);
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr, int n)
+{
+  printf("=check-me= %s - %s (n=%d)\n", cond ? "SUCCEEDED" : "FAILED", descr, n);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_pool(struct memb *m)
+{
+  int i, j, n;
+  int ok;
+  struct block b;
+
+  n = m->num;
+  memb_init(m);
+
+  /* Fill the pool: all blocks must be distinct and inside the pool */
+  ok = 1;
+  for(i = 0; i < n; i++) {
+    blocks[i] = memb_alloc(m);
+    if(blocks[i] == NULL || !memb_inmemb(m, blocks[i])) {
+      ok = 0;
+    }
+    for(j = 0; j < i; j++) {
+      if(blocks[j] == blocks[i]) {
+        ok = 0;
+      }
+    }
+  }
+  check(ok, "allocates every block once", n);
+  check(memb_alloc(m) == NULL && memb_numfree(m) == 0,
+        "fails when full", n);
+
+  /* Pointers that are not blocks of the pool are rejected */
+  check(memb_free(m, &b) == -1 &&
+        memb_free(m, (char *)blocks[0] + 1) == -1,
+        "rejects foreign pointers", n);
+
+  /* Free every other block, then the rest */
+  ok = 1;
+  for(i = 0; i < n; i += 2) {
+    ok &= memb_free(m, blocks[i]) == 0;
+  }
+  check(ok && memb_numfree(m) == n / 2, "frees half the blocks", n);
+  check(memb_free(m, blocks[0]) == 0 && memb_numfree(m) == n / 2,
+        "ignores double free", n);
+  for(i = 1; i < n; i += 2) {
+    ok &= memb_free(m, blocks[i]) == 0;
+  }
+  check(ok && memb_numfree(m) == n, "frees all blocks", n);
+
+  /* Freed blocks are handed out again */
+  ok = 1;
+  for(i = 0; i < n; i++) {
+    struct block *p = memb_alloc(m);
+    ok &= p != NULL && memb_inmemb(m, p);
+  }
+  check(ok && memb_alloc(m) == NULL, "reuses freed blocks", n);
+
+#if MEMB_WITH_FREE_LIST
+  check(m->used_max == n && m->failures == 2, "counts peak usage and failures", n);
+#endif /* MEMB_WITH_FREE_LIST */
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench_pool(struct memb *m)
+{
+  int i, rep, n, used;
+  uint64_t start, alloc_ns, free_ns;
+  unsigned long ops;
+
+  n = m->num;
+  memb_init(m);
+
+  /* Fill and drain the pool */
+  alloc_ns = free_ns = 0;
+  for(rep = 0; rep < FILL_REPETITIONS; rep++) {
+    start = now_ns();
+    for(i = 0; i < n; i++) {
+      blocks[i] = memb_alloc(m);
+    }
+    alloc_ns += now_ns() - start;
+    start = now_ns();
+    for(i = 0; i < n; i++) {
+      memb_free(m, blocks[i]);
+    }
+    free_ns += now_ns() - start;
+  }
+  ops = (unsigned long)FILL_REPETITIONS * n;
+
+  printf("memb-bench: %3d blocks, fill: alloc %4lu ns, free %4lu ns",
+         n, (unsigned long)(alloc_ns / ops), (unsigned long)(free_ns / ops));
+
+  /* Allocate and free random blocks of a half-full pool */
+  for(used = 0; used < n / 2; used++) {
+    blocks[used] = memb_alloc(m);
+  }
+  start = now_ns();
+  for(i = 0; i < CHURN_OPERATIONS; i++) {
+    int victim = random_rand() % used;
+    memb_free(m, blocks[victim]);
+    blocks[victim] = memb_alloc(m);
+  }
+  printf(", churn: alloc+free %4lu ns\n",
+         (unsigned long)((now_ns() - start) / CHURN_OPERATIONS));
+
+  check(memb_numfree(m) == n - used, "keeps count during churn", n);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(memb_bench_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("memb allocator: %s\n",
+         MEMB_WITH_FREE_LIST ? "free list" : "linear search");
+
+  for(i = 0; i < sizeof(pools) / sizeof(pools[0]); i++) {
+    check_pool(pools[i]);
+  }
+  for(i = 0; i < sizeof(pools) / sizeof(pools[0]); i++) {
+    bench_pool(pools[i]);
+  }
+
+  printf("=check-me= DONE\n");
+  exit(failed);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
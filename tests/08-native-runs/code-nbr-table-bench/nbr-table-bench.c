@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark of neighbor table lookups. Fills a neighbor table,
+ *         measures the cost of nbr_table_get_from_lladdr() for
+ *         neighbors that are in the table and for unknown ones, and
+ *         checks that lookups stay correct as neighbors are evicted.
+ */
+
+#include "contiki.h"
+#include "net/nbr-table.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define LOOKUPS 200000
+
+struct bench_nbr {
+  uint32_t id;
+};
+
+NBR_TABLE(struct bench_nbr, bench_table);
+
+static int failed;
+/*---------------------------------------------------------------------------*/
+PROCESS(nbr_table_bench_process, "nbr-table benchmark");
+AUTOSTART_PROCESSES(&nbr_table_bench_process);
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr)
+{
+  printf("=check-me= %s - %s (n=%d)\n", cond ? "SUCCEEDED" : "FAILED", descr,
+         NBR_TABLE_MAX_NEIGHBORS);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The link-layer address of the neighbor with a given id */
+static void
+make_lladdr(linkaddr_t *lladdr, uint32_t id)
+{
+  int i;
+
+  linkaddr_copy(lladdr, &linkaddr_null);
+  lladdr->u8[0] = 0x02;
+  for(i = 0; i < 4 && i < LINKADDR_SIZE - 1; i++) {
+    lladdr->u8[LINKADDR_SIZE - 1 - i] = id >> (8 * i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static struct bench_nbr *
+lookup(uint32_t id)
+{
+  linkaddr_t lladdr;
+
+  make_lladdr(&lladdr, id);
+  return nbr_table_get_from_lladdr(bench_table, &lladdr);
+}
+/*---------------------------------------------------------------------------*/
+/* Check that the neighbors with ids [first, first + n) are all in the
+   table, with their own data, and that the next n ones are not */
+static int
+table_holds(uint32_t first, int n)
+{
+  struct bench_nbr *nbr;
+  uint32_t id;
+
+  for(id = first; id < first + n; id++) {
+    nbr = lookup(id);
+    if(nbr == NULL || nbr->id != id) {
+      return 0;
+    }
+  }
+  for(id = first + n; id < first + 2 * n; id++) {
+    if(lookup(id) != NULL) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+add_neighbors(uint32_t first, int n)
+{
+  struct bench_nbr *nbr;
+  linkaddr_t lladdr;
+  uint32_t id;
+
+  for(id = first; id < first + n; id++) {
+    make_lladdr(&lladdr, id);
+    nbr = nbr_table_add_lladdr(bench_table, &lladdr,
+                               NBR_TABLE_REASON_UNDEFINED, NULL);
+    if(nbr == NULL) {
+      return 0;
+    }
+    nbr->id = id;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(nbr_table_bench_process, ev, data)
+{
+  static const int n = NBR_TABLE_MAX_NEIGHBORS;
+  uint64_t start, hit_ns, miss_ns;
+  int i, found;
+
+  PROCESS_BEGIN();
+
+  nbr_table_register(bench_table, NULL);
+
+  check(add_neighbors(0, n), "fills the table");
+  check(table_holds(0, n), "finds every neighbor");
+
+  found = 0;
+  start = now_ns();
+  for(i = 0; i < LOOKUPS; i++) {
+    found += lookup(random_rand() % n) != NULL;
+  }
+  hit_ns = now_ns() - start;
+  start = now_ns();
+  for(i = 0; i < LOOKUPS; i++) {
+    found += lookup(n + random_rand() % n) != NULL;
+  }
+  miss_ns = now_ns() - start;
+  check(found == LOOKUPS, "lookups return the neighbors in the table");
+
+  printf("nbr-table-bench: %4d neighbors, %s, lookup %5lu ns (known), %5lu ns (unknown)\n",
+         n, NBR_TABLE_WITH_HASH ? "hash index" : "list walk",
+         (unsigned long)(hit_ns / LOOKUPS), (unsigned long)(miss_ns / LOOKUPS));
+
+  /* Replace all neighbors, one at a time, through eviction */
+  check(add_neighbors(n, n), "evicts neighbors when full");
+  check(table_holds(n, n), "finds neighbors after eviction");
+  for(i = 0; i < n; i++) {
+    if(lookup(i) != NULL) {
+      break;
+    }
+  }
+  check(i == n, "forgets evicted neighbors");
+
+  /* Neighbors removed from the table are no longer found */
+  nbr_table_remove(bench_table, lookup(n));
+  check(lookup(n) == NULL && lookup(n + 1) != NULL, "forgets removed neighbors");
+
+  printf("=check-me= DONE\n");
+  exit(failed);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
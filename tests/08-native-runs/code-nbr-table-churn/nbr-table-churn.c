@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Churn simulation of the neighbor table. A set of active
+ *         neighbors is heard in every round, while new transient
+ *         neighbors keep showing up once and push older neighbors out
+ *         of the full table. Two neighbors are locked by a second
+ *         table and never heard again. The simulation reports how
+ *         often active neighbors were evicted, and the cost of
+ *         admitting a new neighbor in a full table.
+ */
+
+#include "contiki.h"
+#include "net/nbr-table.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define ROUNDS 200
+#define NUM_LOCKED 2
+#define NUM_ACTIVE (NBR_TABLE_MAX_NEIGHBORS / 2)
+#define TRANSIENTS_PER_ROUND (NBR_TABLE_MAX_NEIGHBORS / 4)
+
+/* Ids: locked neighbors first, then active ones, then transient ones */
+#define FIRST_ACTIVE NUM_LOCKED
+#define FIRST_TRANSIENT (NUM_LOCKED + NUM_ACTIVE)
+
+struct churn_nbr {
+  uint32_t id;
+};
+
+/* Like link-stats: every neighbor that is heard */
+NBR_TABLE(struct churn_nbr, heard_table);
+/* Like a routing protocol: a few neighbors, locked */
+NBR_TABLE(struct churn_nbr, locked_table);
+
+static int failed;
+/*---------------------------------------------------------------------------*/
+PROCESS(nbr_table_churn_process, "nbr-table churn");
+AUTOSTART_PROCESSES(&nbr_table_churn_process);
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr)
+{
+  printf("=check-me= %s - %s (n=%d)\n", cond ? "SUCCEEDED" : "FAILED", descr,
+         NBR_TABLE_MAX_NEIGHBORS);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+make_lladdr(linkaddr_t *lladdr, uint32_t id)
+{
+  int i;
+
+  linkaddr_copy(lladdr, &linkaddr_null);
+  lladdr->u8[0] = 0x02;
+  for(i = 0; i < 4 && i < LINKADDR_SIZE - 1; i++) {
+    lladdr->u8[LINKADDR_SIZE - 1 - i] = id >> (8 * i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* A frame is received from a neighbor: returns 1 if the neighbor had
+   to be admitted to the table, 0 if it was known, -1 on failure */
+static int
+hear(uint32_t id)
+{
+  struct churn_nbr *nbr;
+  linkaddr_t lladdr;
+
+  make_lladdr(&lladdr, id);
+  nbr = nbr_table_get_from_lladdr(heard_table, &lladdr);
+  if(nbr != NULL) {
+    nbr_table_touch(heard_table, nbr);
+    return 0;
+  }
+  nbr = nbr_table_add_lladdr(heard_table, &lladdr,
+                             NBR_TABLE_REASON_LINK_STATS, NULL);
+  if(nbr == NULL) {
+    return -1;
+  }
+  nbr->id = id;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(nbr_table_churn_process, ev, data)
+{
+  static uint32_t next_transient;
+  struct churn_nbr *nbr;
+  linkaddr_t lladdr;
+  uint64_t start, admit_ns;
+  unsigned long admissions, active_evictions;
+  int round, i, ret, failures, locked_ok;
+
+  PROCESS_BEGIN();
+
+  nbr_table_register(heard_table, NULL);
+  nbr_table_register(locked_table, NULL);
+
+  for(i = 0; i < NUM_LOCKED; i++) {
+    make_lladdr(&lladdr, i);
+    nbr = nbr_table_add_lladdr(locked_table, &lladdr, NBR_TABLE_REASON_ROUTE, NULL);
+    nbr_table_lock(locked_table, nbr);
+    hear(i);
+  }
+
+  failures = 0;
+  admissions = 0;
+  active_evictions = 0;
+  admit_ns = 0;
+  next_transient = FIRST_TRANSIENT;
+
+  for(round = 0; round < ROUNDS; round++) {
+    for(i = FIRST_ACTIVE; i < FIRST_TRANSIENT; i++) {
+      ret = hear(i);
+      if(ret < 0) {
+        failures++;
+      } else if(ret > 0 && round > 0) {
+        /* The neighbor was heard in the previous round, but evicted */
+        active_evictions++;
+      }
+    }
+    for(i = 0; i < TRANSIENTS_PER_ROUND; i++) {
+      start = now_ns();
+      ret = hear(next_transient++);
+      admit_ns += now_ns() - start;
+      admissions++;
+      if(ret < 0) {
+        failures++;
+      }
+    }
+  }
+
+  locked_ok = 1;
+  for(i = 0; i < NUM_LOCKED; i++) {
+    make_lladdr(&lladdr, i);
+    nbr = nbr_table_get_from_lladdr(locked_table, &lladdr);
+    locked_ok &= nbr != NULL;
+  }
+
+  printf("nbr-table-churn: %4d neighbors, %s eviction, %lu active neighbors evicted, "
+         "admission %lu ns\n",
+         NBR_TABLE_MAX_NEIGHBORS, NBR_TABLE_LRU_EVICTION ? "LRU" : "scan",
+         active_evictions, (unsigned long)(admit_ns / admissions));
+
+  check(failures == 0, "admits every neighbor");
+  check(locked_ok, "keeps locked neighbors");
+#if NBR_TABLE_LRU_EVICTION
+  check(active_evictions == 0, "keeps active neighbors");
+#endif /* NBR_TABLE_LRU_EVICTION */
+
+  printf("=check-me= DONE\n");
+  exit(failed);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark of the packetbuf operations done for every frame
+ *         sent: the packet is cleared, its payload and attributes are
+ *         set, and a link-layer header is prepended. Clearing the
+ *         attributes and prepending headers beyond the headroom are
+ *         checked as well.
+ */
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define FRAMES 100000
+#define REPEATS 5
+#define PAYLOAD_LEN 90
+#define MAC_HDR_LEN 23
+#define SHORT_PAYLOAD_LEN 40
+
+static uint8_t payload[PAYLOAD_LEN];
+static uint8_t mac_hdr[MAC_HDR_LEN];
+static uint8_t adopted[PACKETBUF_SIZE];
+static linkaddr_t next_hop = {{ 0x02, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07 }};
+static int failed;
+/*---------------------------------------------------------------------------*/
+PROCESS(packetbuf_frame_process, "packetbuf frame benchmark");
+AUTOSTART_PROCESSES(&packetbuf_frame_process);
+/*---------------------------------------------------------------------------*/
+#if defined(__i386__) || defined(__x86_64__)
+#define UNIT "cycles"
+#define now() __builtin_ia32_rdtsc()
+#else
+#define UNIT "ns"
+static uint64_t
+now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+#endif
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr, int n)
+{
+  printf("=check-me= %s - %s (n=%d)\n", cond ? "SUCCEEDED" : "FAILED", descr, n);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_attrs(void)
+{
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &next_hop);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, 42);
+  packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, 1);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS, 3);
+}
+/*---------------------------------------------------------------------------*/
+/* Build a frame the way the network and MAC layers do */
+static void
+build_frame(void)
+{
+  packetbuf_clear();
+  memcpy(packetbuf_dataptr(), payload, PAYLOAD_LEN);
+  packetbuf_set_datalen(PAYLOAD_LEN);
+  set_attrs();
+  if(packetbuf_hdralloc(MAC_HDR_LEN)) {
+    memcpy(packetbuf_hdrptr(), mac_hdr, MAC_HDR_LEN);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+frame_intact(int hdr_len, int payload_len)
+{
+  return packetbuf_totlen() == hdr_len + payload_len &&
+    memcmp(packetbuf_hdrptr(), mac_hdr, MIN(hdr_len, MAC_HDR_LEN)) == 0 &&
+    memcmp((uint8_t *)packetbuf_hdrptr() + hdr_len, payload, payload_len) == 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+attrs_cleared(void)
+{
+  int type;
+
+  for(type = 0; type < PACKETBUF_NUM_ATTRS; type++) {
+    if(packetbuf_attr(type) != 0) {
+      return 0;
+    }
+  }
+  return linkaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_SENDER), &linkaddr_null) &&
+    linkaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_RECEIVER), &linkaddr_null);
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench_frames(void)
+{
+  uint64_t start, elapsed, best;
+  int i, r;
+
+  best = UINT64_MAX;
+  for(r = 0; r < REPEATS; r++) {
+    start = now();
+    for(i = 0; i < FRAMES; i++) {
+      build_frame();
+    }
+    elapsed = now() - start;
+    best = MIN(best, elapsed);
+  }
+
+  printf("packetbuf-frame: headroom %d, %lu " UNIT " per frame\n",
+         PACKETBUF_HEADROOM, (unsigned long)(best / FRAMES));
+  check(frame_intact(MAC_HDR_LEN, PAYLOAD_LEN), "frame intact", PACKETBUF_HEADROOM);
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench_attr_clear(void)
+{
+  uint64_t start, elapsed, best;
+  int i, r;
+
+  best = UINT64_MAX;
+  for(r = 0; r < REPEATS; r++) {
+    start = now();
+    for(i = 0; i < FRAMES; i++) {
+      set_attrs();
+      packetbuf_attr_clear();
+    }
+    elapsed = now() - start;
+    best = MIN(best, elapsed);
+  }
+
+  printf("packetbuf-frame: headroom %d, %lu " UNIT " per attribute set and clear\n",
+         PACKETBUF_HEADROOM, (unsigned long)(best / FRAMES));
+  check(attrs_cleared(), "attributes cleared", PACKETBUF_NUM_ATTRS);
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_headers(void)
+{
+  struct packetbuf_attr attrs[PACKETBUF_NUM_ATTRS];
+  struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
+  int ok;
+
+  /* Headers beyond the headroom shift the packet */
+  packetbuf_copyfrom(payload, SHORT_PAYLOAD_LEN);
+  ok = packetbuf_hdralloc(MAC_HDR_LEN);
+  memcpy(packetbuf_hdrptr(), mac_hdr, MAC_HDR_LEN);
+  ok &= packetbuf_hdralloc(PACKETBUF_HEADROOM + 1);
+  memcpy(packetbuf_hdrptr(), mac_hdr, MAC_HDR_LEN);
+  check(ok && frame_intact(PACKETBUF_HEADROOM + 1 + MAC_HDR_LEN,
+                           SHORT_PAYLOAD_LEN),
+        "header beyond headroom", PACKETBUF_HEADROOM + 1);
+  check(!packetbuf_hdralloc(PACKETBUF_SIZE), "header too large",
+        PACKETBUF_SIZE);
+
+  /* Adopted buffers are copied before a header is prepended */
+  memcpy(adopted, payload, PAYLOAD_LEN);
+  packetbuf_adopt(adopted, PAYLOAD_LEN, NULL);
+  ok = packetbuf_hdralloc(MAC_HDR_LEN);
+  memcpy(packetbuf_hdrptr(), mac_hdr, MAC_HDR_LEN);
+  check(ok && frame_intact(MAC_HDR_LEN, PAYLOAD_LEN) &&
+        memcmp(adopted, payload, PAYLOAD_LEN) == 0,
+        "header on adopted buffer", MAC_HDR_LEN);
+
+  /* Attributes restored from a copy are cleared as well */
+  set_attrs();
+  packetbuf_attr_copyto(attrs, addrs);
+  packetbuf_clear();
+  packetbuf_attr_copyfrom(attrs, addrs);
+  ok = packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO) == 42 &&
+    linkaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_RECEIVER), &next_hop);
+  packetbuf_clear();
+  check(ok && attrs_cleared(), "restored attributes cleared",
+        PACKETBUF_NUM_ATTRS);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(packetbuf_frame_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  for(i = 0; i < PAYLOAD_LEN; i++) {
+    payload[i] = i * 7;
+  }
+  for(i = 0; i < MAC_HDR_LEN; i++) {
+    mac_hdr[i] = 0x80 | i;
+  }
+
+  bench_frames();
+  bench_attr_clear();
+  test_headers();
+
+  printf("=check-me= DONE\n");
+  exit(failed);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
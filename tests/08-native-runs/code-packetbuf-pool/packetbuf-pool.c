@@ -0,0 +1,378 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark of the packet descriptor pool. Two scenarios are
+ *         measured: frames received while a packet is being prepared
+ *         for transmission, and the generation of 6LoWPAN-like
+ *         fragments from a common set of headers. With a single
+ *         packet descriptor, the packet in packetbuf is saved to a
+ *         queuebuf and restored, as done by sicslowpan. With several
+ *         descriptors, another descriptor is selected instead.
+ */
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "net/mac/framer/framer-802154.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define ROUNDS 10000
+#define REPEATS 5
+#define TX_LEN 90
+#define RX_PER_TX 2
+#define IP_LEN 1280
+#define FRAG_HDR_LEN 10
+#define FRAG_PAYLOAD_LEN 88
+
+static uint8_t tx_payload[TX_LEN];
+static uint8_t rx_frame[PACKETBUF_SIZE];
+static int rx_frame_len;
+static uint8_t ip_packet[IP_LEN];
+static linkaddr_t next_hop = {{ 0x02, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07 }};
+static int failed;
+/*---------------------------------------------------------------------------*/
+PROCESS(packetbuf_pool_process, "packetbuf pool benchmark");
+AUTOSTART_PROCESSES(&packetbuf_pool_process);
+/*---------------------------------------------------------------------------*/
+#if defined(__i386__) || defined(__x86_64__)
+#define UNIT "cycles"
+#define now() __builtin_ia32_rdtsc()
+#else
+#define UNIT "ns"
+static uint64_t
+now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+#endif
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr, int n)
+{
+  printf("=check-me= %s - %s (n=%d)\n", cond ? "SUCCEEDED" : "FAILED", descr, n);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+checksum(const uint8_t *data, int len)
+{
+  uint32_t sum = 0;
+  int i;
+
+  for(i = 0; i < len; i++) {
+    sum = sum * 31 + data[i];
+  }
+  return sum;
+}
+/*---------------------------------------------------------------------------*/
+/* Stands for the radio: returns a checksum of the frame in packetbuf */
+static uint32_t
+transmit(void)
+{
+  return checksum(packetbuf_hdrptr(), packetbuf_totlen());
+}
+/*---------------------------------------------------------------------------*/
+static void
+prepare_tx(void)
+{
+  packetbuf_copyfrom(tx_payload, TX_LEN);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &next_hop);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, 42);
+  packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, FRAME802154_DATAFRAME);
+}
+/*---------------------------------------------------------------------------*/
+/* Receive and parse a frame, without disturbing the packet in packetbuf.
+   Returns 0 if the frame could not be parsed. */
+static int
+receive(void)
+{
+  int ok;
+#if PACKETBUF_NUM > 1
+  struct packetbuf *rx = packetbuf_alloc();
+  struct packetbuf *prev;
+
+  if(rx == NULL) {
+    return 0;
+  }
+  prev = packetbuf_select(rx);
+  packetbuf_copyfrom(rx_frame, rx_frame_len);
+  ok = framer_802154.parse() > 0 && packetbuf_datalen() == TX_LEN;
+  packetbuf_select(prev);
+  packetbuf_free(rx);
+#else /* PACKETBUF_NUM > 1 */
+  struct queuebuf *q = queuebuf_new_from_packetbuf();
+
+  if(q == NULL) {
+    return 0;
+  }
+  packetbuf_copyfrom(rx_frame, rx_frame_len);
+  ok = framer_802154.parse() > 0 && packetbuf_datalen() == TX_LEN;
+  queuebuf_to_packetbuf(q);
+  queuebuf_free(q);
+#endif /* PACKETBUF_NUM > 1 */
+  return ok;
+}
+/*---------------------------------------------------------------------------*/
+/* Send one fragment: the headers in packetbuf, followed by a payload
+   from the IP packet */
+static uint32_t
+send_fragment(int offset, int len)
+{
+  uint32_t sum = 0;
+#if PACKETBUF_NUM > 1
+  struct packetbuf *frag = packetbuf_alloc();
+  struct packetbuf *headers;
+
+  if(frag == NULL) {
+    return 0;
+  }
+  packetbuf_set_datalen(FRAG_HDR_LEN);
+  headers = packetbuf_select(frag);
+  packetbuf_copyfrom_packetbuf(headers);
+  memcpy((uint8_t *)packetbuf_dataptr() + FRAG_HDR_LEN, ip_packet + offset, len);
+  packetbuf_set_datalen(FRAG_HDR_LEN + len);
+  if(framer_802154.create() >= 0) {
+    sum = transmit();
+  }
+  packetbuf_select(headers);
+  packetbuf_free(frag);
+#else /* PACKETBUF_NUM > 1 */
+  struct queuebuf *q;
+
+  memcpy((uint8_t *)packetbuf_dataptr() + FRAG_HDR_LEN, ip_packet + offset, len);
+  packetbuf_set_datalen(FRAG_HDR_LEN + len);
+  q = queuebuf_new_from_packetbuf();
+  if(q == NULL) {
+    return 0;
+  }
+  if(framer_802154.create() >= 0) {
+    sum = transmit();
+  }
+  queuebuf_to_packetbuf(q);
+  queuebuf_free(q);
+#endif /* PACKETBUF_NUM > 1 */
+  return sum;
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench_rx_while_tx(void)
+{
+  uint64_t start, elapsed, best;
+  uint32_t expected, sum;
+  int i, j, r, ok;
+
+  /* The frame expected on the air */
+  prepare_tx();
+  framer_802154.create();
+  expected = transmit();
+
+  ok = 1;
+  best = UINT64_MAX;
+  for(r = 0; r < REPEATS; r++) {
+    start = now();
+    for(i = 0; i < ROUNDS; i++) {
+      prepare_tx();
+      for(j = 0; j < RX_PER_TX; j++) {
+        ok &= receive();
+      }
+      ok &= framer_802154.create() >= 0;
+      sum = transmit();
+      ok &= sum == expected;
+    }
+    elapsed = now() - start;
+    best = MIN(best, elapsed);
+  }
+
+  printf("packetbuf-pool: %d descriptor(s), %d frame(s) received while sending: %lu " UNIT " per packet sent\n",
+         PACKETBUF_NUM, RX_PER_TX, (unsigned long)(best / ROUNDS));
+  check(ok, "transmitted and received frames intact", RX_PER_TX);
+}
+/*---------------------------------------------------------------------------*/
+/* Send an IP packet in fragments. Returns 0 if any fragment was not
+   as expected. */
+static int
+fragment(int *count)
+{
+  static uint32_t expected[IP_LEN / FRAG_PAYLOAD_LEN + 1];
+  uint32_t sum;
+  int n, offset, ok;
+
+  /* The fragment headers, as compressed by sicslowpan */
+  packetbuf_clear();
+  memset(packetbuf_dataptr(), 0xc0, FRAG_HDR_LEN);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &next_hop);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, 42);
+  packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, FRAME802154_DATAFRAME);
+
+  ok = 1;
+  for(n = 0, offset = 0; offset < IP_LEN; n++, offset += FRAG_PAYLOAD_LEN) {
+    sum = send_fragment(offset, MIN(FRAG_PAYLOAD_LEN, IP_LEN - offset));
+    if(*count == 0) {
+      expected[n] = sum;
+    }
+    ok &= sum != 0 && sum == expected[n];
+  }
+  *count = n;
+  return ok;
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench_fragments(void)
+{
+  uint64_t start, elapsed, best;
+  int i, n, r, ok;
+
+  n = 0;
+  ok = 1;
+  best = UINT64_MAX;
+  for(r = 0; r < REPEATS; r++) {
+    start = now();
+    for(i = 0; i < ROUNDS / 10; i++) {
+      ok &= fragment(&n);
+    }
+    elapsed = now() - start;
+    best = MIN(best, elapsed);
+  }
+
+  printf("packetbuf-pool: %d descriptor(s), %d fragments: %lu " UNIT " per packet\n",
+         PACKETBUF_NUM, n, (unsigned long)(best / (ROUNDS / 10)));
+  check(ok, "fragments intact", n);
+}
+#if QUEUEBUF_ZERO_COPY
+/*---------------------------------------------------------------------------*/
+/* Every packet descriptor may keep the data of a freed queuebuf, which
+   must not make queuebufs unavailable */
+static void
+test_adopted_data(void)
+{
+  static struct queuebuf *qs[QUEUEBUF_NUM];
+  struct packetbuf *descs[PACKETBUF_NUM];
+  struct queuebuf *q;
+  int i, n;
+
+  descs[0] = NULL;
+  for(i = 1; i < PACKETBUF_NUM; i++) {
+    descs[i] = packetbuf_alloc();
+  }
+  for(i = 0; i < PACKETBUF_NUM; i++) {
+    packetbuf_select(descs[i]);
+    prepare_tx();
+    q = queuebuf_new_from_packetbuf();
+    if(q != NULL) {
+      queuebuf_to_packetbuf(q);
+      queuebuf_free(q);
+    }
+  }
+  packetbuf_select(NULL);
+
+  for(n = 0; n < QUEUEBUF_NUM; n++) {
+    qs[n] = queuebuf_new_from_packetbuf();
+    if(qs[n] == NULL) {
+      break;
+    }
+  }
+  check(n == QUEUEBUF_NUM, "queuebufs available with adopted data", n);
+  for(i = 0; i < n; i++) {
+    queuebuf_free(qs[i]);
+  }
+
+  for(i = PACKETBUF_NUM - 1; i >= 0; i--) {
+    packetbuf_select(descs[i]);
+    packetbuf_clear();
+    if(descs[i] != NULL) {
+      packetbuf_free(descs[i]);
+    }
+  }
+  packetbuf_select(NULL);
+}
+#endif /* QUEUEBUF_ZERO_COPY */
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(packetbuf_pool_process, ev, data)
+{
+  static struct queuebuf *qs[QUEUEBUF_NUM];
+  int i, n;
+
+  PROCESS_BEGIN();
+
+  for(i = 0; i < TX_LEN; i++) {
+    tx_payload[i] = i * 7;
+  }
+  for(i = 0; i < IP_LEN; i++) {
+    ip_packet[i] = i * 13;
+  }
+  queuebuf_init();
+
+  /* A frame sent by a neighbor */
+  prepare_tx();
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &linkaddr_node_addr);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &next_hop);
+  framer_802154.create();
+  rx_frame_len = packetbuf_copyto(rx_frame);
+
+  bench_rx_while_tx();
+  bench_fragments();
+
+  /* No queuebuf may be leaked */
+  packetbuf_clear();
+  for(n = 0; n < QUEUEBUF_NUM; n++) {
+    qs[n] = queuebuf_new_from_packetbuf();
+    if(qs[n] == NULL) {
+      break;
+    }
+  }
+  check(n == QUEUEBUF_NUM, "all queuebufs available", n);
+  for(i = 0; i < n; i++) {
+    queuebuf_free(qs[i]);
+  }
+#if QUEUEBUF_ZERO_COPY
+  test_adopted_data();
+#endif /* QUEUEBUF_ZERO_COPY */
+
+  printf("=check-me= DONE\n");
+  exit(failed);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark of the process scheduler. Measures the latency
+ *         between polling a process and the process running, with
+ *         10, 100 and 1000 processes, either when the polled process
+ *         is the only one to be polled or when all other processes
+ *         were polled before it.
+ */
+
+#include "contiki.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define MAX_PROCESSES 1000
+#define REPETITIONS 200
+
+static struct process dummies[MAX_PROCESSES];
+static const int sizes[] = { 10, 100, 1000 };
+static uint64_t poll_time;
+static uint64_t run_time;
+static unsigned long dummy_polls;
+static unsigned long dummy_polls_before;
+static int failed;
+/*---------------------------------------------------------------------------*/
+PROCESS(process_bench_process, "Process benchmark");
+PROCESS(target_process, "Target");
+PROCESS(dummy_process, "Dummy");
+AUTOSTART_PROCESSES(&process_bench_process);
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr, int n)
+{
+  printf("=check-me= %s - %s (n=%d)\n", cond ? "SUCCEEDED" : "FAILED", descr, n);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(dummy_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD();
+    if(ev == PROCESS_EVENT_POLL) {
+      dummy_polls++;
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(target_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD();
+    if(ev == PROCESS_EVENT_POLL) {
+      run_time = now_ns();
+      dummy_polls_before = dummy_polls;
+      process_post(&process_bench_process, PROCESS_EVENT_CONTINUE, NULL);
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(process_bench_process, ev, data)
+{
+  static int s, n, i, rep, started, polls_ok;
+  static uint64_t idle_ns, loaded_ns;
+  static unsigned long snapshot;
+
+  PROCESS_BEGIN();
+
+  printf("Process scheduler: %s, %u priority level(s)\n",
+         PROCESS_POLL_QUEUE ? "poll queue" : "process list",
+         PROCESS_PRIORITIES);
+
+  /* Started first, the target ends up last on the process list */
+  process_set_priority(&target_process, PROCESS_PRIORITY_HIGH);
+  process_start(&target_process, NULL);
+
+  started = 0;
+  for(s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    n = sizes[s];
+    for(; started < n; started++) {
+      dummies[started] = dummy_process;
+      process_start(&dummies[started], NULL);
+    }
+
+    /* Only the target is polled */
+    idle_ns = 0;
+    for(rep = 0; rep < REPETITIONS; rep++) {
+      poll_time = now_ns();
+      process_poll(&target_process);
+      PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_CONTINUE);
+      idle_ns += run_time - poll_time;
+    }
+
+    /* All processes are polled, the target last */
+    loaded_ns = 0;
+    polls_ok = 1;
+    for(rep = 0; rep < REPETITIONS; rep++) {
+      snapshot = dummy_polls;
+      for(i = 0; i < n; i++) {
+        process_poll(&dummies[i]);
+      }
+      poll_time = now_ns();
+      process_poll(&target_process);
+      PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_CONTINUE);
+      loaded_ns += run_time - poll_time;
+      if(dummy_polls - snapshot != n) {
+        polls_ok = 0;
+      }
+    }
+    check(polls_ok, "all polled processes called", n);
+    if(PROCESS_PRIORITIES > 1) {
+      check(dummy_polls_before == snapshot,
+            "high priority process called first", n);
+    }
+
+    printf("process-bench: n %4d idle %6lu ns loaded %8lu ns\n", n,
+           (unsigned long)(idle_ns / REPETITIONS),
+           (unsigned long)(loaded_ns / REPETITIONS));
+  }
+
+  printf("=check-me= %s\n", failed ? "FAILED" : "DONE");
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
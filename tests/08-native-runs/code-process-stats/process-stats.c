@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Test of the event queue statistics and of the growable event
+ *         queue. A burst of events larger than the queue is posted to
+ *         a process, and the events that are delivered or dropped are
+ *         checked against the statistics.
+ */
+
+#include "contiki.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+/*---------------------------------------------------------------------------*/
+#define BURST 100
+
+static int received;
+static int failed;
+/*---------------------------------------------------------------------------*/
+PROCESS(process_stats_process, "Process stats test");
+PROCESS(sink_process, "Sink");
+AUTOSTART_PROCESSES(&process_stats_process);
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr)
+{
+  printf("=check-me= %s - %s\n", cond ? "SUCCEEDED" : "FAILED", descr);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(sink_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD();
+    if(ev == PROCESS_EVENT_CONTINUE) {
+      received++;
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(process_stats_process, ev, data)
+{
+  static int i, posted;
+  static uint32_t events_before;
+
+  PROCESS_BEGIN();
+
+  process_start(&sink_process, NULL);
+  PROCESS_PAUSE();
+
+  process_stats_reset();
+  events_before = sink_process.stats.events;
+
+  posted = 0;
+  for(i = 0; i < BURST; i++) {
+    if(process_post(&sink_process, PROCESS_EVENT_CONTINUE, NULL)
+       == PROCESS_ERR_OK) {
+      posted++;
+    }
+  }
+  printf("Queue size %u, posted %d/%d, max depth %u, overflows %lu\n",
+         process_event_queue_size(), posted, BURST, process_maxevents,
+         (unsigned long)process_overflows);
+
+  check(process_overflows == BURST - posted, "overflows counted");
+  check(sink_process.stats.overflows == BURST - posted,
+        "process overflows counted");
+  check(process_maxevents <= process_event_queue_size(),
+        "max depth within queue size");
+  if(PROCESS_GROWABLE_EVENTS) {
+    check(posted == BURST, "queue grown");
+  } else {
+    check(posted < BURST, "queue overflowed");
+  }
+
+  /* Let the sink drain the queue. Polls do not go through the queue,
+     which may still be full. */
+  for(i = 0; i < 2 * BURST && received < posted; i++) {
+    process_poll(PROCESS_CURRENT());
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+  }
+  check(received == posted, "all posted events delivered");
+  check(sink_process.stats.events - events_before == posted,
+        "process events counted");
+
+  printf("=check-me= %s\n", failed ? "FAILED" : "DONE");
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Forwarding benchmark of packetbuf and queuebuf. Each packet
+ *         goes through the steps of a forwarding node running CSMA:
+ *         it is received in packetbuf, queued in a queuebuf, put back
+ *         in packetbuf and framed for each transmission attempt, and
+ *         put back in packetbuf for the sent callback. Reports the
+ *         CPU cycles (or nanoseconds) spent per packet, and checks
+ *         that every transmitted frame and every queued packet is
+ *         intact.
+ */
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "net/mac/framer/framer-802154.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define PACKETS 100000
+#define PAYLOAD_LEN 90
+
+static uint8_t payload[PAYLOAD_LEN];
+static linkaddr_t next_hop = {{ 0x02, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07 }};
+static int failed;
+/*---------------------------------------------------------------------------*/
+PROCESS(queuebuf_bench_process, "queuebuf benchmark");
+AUTOSTART_PROCESSES(&queuebuf_bench_process);
+/*---------------------------------------------------------------------------*/
+#if defined(__i386__) || defined(__x86_64__)
+#define UNIT "cycles"
+#define now() __builtin_ia32_rdtsc()
+#else
+#define UNIT "ns"
+static uint64_t
+now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+#endif
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr, int n)
+{
+  printf("=check-me= %s - %s (n=%d)\n", cond ? "SUCCEEDED" : "FAILED", descr, n);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Stands for the radio: returns a checksum of the frame */
+static uint32_t
+transmit(void)
+{
+  const uint8_t *frame = packetbuf_hdrptr();
+  uint32_t sum = 0;
+  int i;
+
+  for(i = 0; i < packetbuf_totlen(); i++) {
+    sum = sum * 31 + frame[i];
+  }
+  return sum;
+}
+/*---------------------------------------------------------------------------*/
+/* Forward one packet with a number of transmission attempts. Returns
+   0 if any frame or the queued packet was not as expected. */
+static int
+forward(int attempts, uint32_t *frame_sum)
+{
+  struct queuebuf *q;
+  uint32_t sum;
+  int ok = 1;
+  int i;
+
+  /* Received from the radio, then prepared for the next hop */
+  packetbuf_copyfrom(payload, PAYLOAD_LEN);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &next_hop);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, 42);
+  packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, FRAME802154_DATAFRAME);
+
+  /* Queued by the MAC layer */
+  q = queuebuf_new_from_packetbuf();
+  if(q == NULL) {
+    return 0;
+  }
+
+  /* Transmission attempts */
+  for(i = 0; i < attempts; i++) {
+    queuebuf_to_packetbuf(q);
+    if(framer_802154.create() < 0) {
+      ok = 0;
+      break;
+    }
+    sum = transmit();
+    if(*frame_sum == 0) {
+      *frame_sum = sum;
+    }
+    ok &= sum == *frame_sum;
+  }
+
+  /* The queued packet must not have been modified by framing */
+  ok &= queuebuf_datalen(q) == PAYLOAD_LEN &&
+    memcmp(queuebuf_dataptr(q), payload, PAYLOAD_LEN) == 0;
+
+  /* Sent callback */
+  queuebuf_to_packetbuf(q);
+  ok &= packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO) == 42 &&
+    packetbuf_datalen() == PAYLOAD_LEN &&
+    memcmp(packetbuf_dataptr(), payload, PAYLOAD_LEN) == 0;
+  queuebuf_free(q);
+
+  return ok;
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench(int attempts)
+{
+  uint64_t start, elapsed;
+  uint32_t frame_sum = 0;
+  int i, ok;
+
+  ok = 1;
+  start = now();
+  for(i = 0; i < PACKETS; i++) {
+    ok &= forward(attempts, &frame_sum);
+  }
+  elapsed = now() - start;
+
+  printf("queuebuf-bench: %s, %d transmission(s): %lu " UNIT " per packet\n",
+         QUEUEBUF_ZERO_COPY ? "zero-copy" : "copy", attempts,
+         (unsigned long)(elapsed / PACKETS));
+  check(ok, "frames and queued packets intact", attempts);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(queuebuf_bench_process, ev, data)
+{
+  static struct queuebuf *qs[QUEUEBUF_NUM];
+  int i, n;
+
+  PROCESS_BEGIN();
+
+  for(i = 0; i < PAYLOAD_LEN; i++) {
+    payload[i] = i * 7;
+  }
+  queuebuf_init();
+
+  bench(1);
+  bench(3);
+
+  /* No buffer may be leaked: all queuebufs can be allocated again */
+  packetbuf_clear();
+  for(n = 0; n < QUEUEBUF_NUM; n++) {
+    qs[n] = queuebuf_new_from_packetbuf();
+    if(qs[n] == NULL) {
+      break;
+    }
+  }
+  check(n == QUEUEBUF_NUM, "all queuebufs available", n);
+  for(i = 0; i < n; i++) {
+    queuebuf_free(qs[i]);
+  }
+
+  printf("=check-me= DONE\n");
+  exit(failed);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark of longest-prefix-match lookups in the IPv6 routing
+ *         table. The table holds host routes, as a storing-mode router
+ *         has for its sub-DODAG, and a few nested prefix routes. Reports
+ *         the CPU cycles (or nanoseconds) per lookup for several table
+ *         sizes, and checks the results against an exhaustive search.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/ipv6/uip-ds6-route.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define LOOKUPS 20000
+#define REPEATS 3
+#define NEXTHOPS 4
+
+static const int sizes[] = { 64, 512, 4096 };
+static uip_ipaddr_t nexthops[NEXTHOPS];
+static int failed;
+/*---------------------------------------------------------------------------*/
+PROCESS(route_lookup_process, "Route lookup benchmark");
+AUTOSTART_PROCESSES(&route_lookup_process);
+/*---------------------------------------------------------------------------*/
+#if defined(__i386__) || defined(__x86_64__)
+#define UNIT "cycles"
+#define now() __builtin_ia32_rdtsc()
+#else
+#define UNIT "ns"
+static uint64_t
+now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+#endif
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr, int n)
+{
+  printf("=check-me= %s - %s (n=%d)\n", cond ? "SUCCEEDED" : "FAILED", descr, n);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_nexthops(void)
+{
+  uip_lladdr_t lladdr;
+  int i;
+
+  for(i = 0; i < NEXTHOPS; i++) {
+    memset(&lladdr, 0, sizeof(lladdr));
+    lladdr.addr[sizeof(lladdr.addr) - 1] = i + 1;
+    uip_ip6addr(&nexthops[i], 0xfe80, 0, 0, 0, 0x0200, 0, 0, i + 1);
+    uip_ds6_nbr_add(&nexthops[i], &lladdr, 1, NBR_REACHABLE,
+                    NBR_TABLE_REASON_UNDEFINED, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Host i of the sub-DODAG, in fd00::/64 */
+static void
+host_addr(uip_ipaddr_t *addr, int i)
+{
+  uip_ip6addr(addr, 0xfd00, 0, 0, 0, 0x0200, 0, i >> 16, i & 0xffff);
+}
+/*---------------------------------------------------------------------------*/
+static int
+build_table(int size)
+{
+  uip_ipaddr_t addr;
+  int i;
+
+  while(uip_ds6_route_head() != NULL) {
+    uip_ds6_route_rm(uip_ds6_route_head());
+  }
+
+  for(i = 1; i <= size - 3; i++) {
+    host_addr(&addr, i);
+    if(uip_ds6_route_add(&addr, 128, &nexthops[i % NEXTHOPS]) == NULL) {
+      return 0;
+    }
+  }
+
+  /* Nested prefixes, to exercise the longest match. Added most specific
+     first, as adding a route replaces the one its address matches. */
+  uip_ip6addr(&addr, 0xfd00, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_route_add(&addr, 64, &nexthops[0]);
+  uip_ip6addr(&addr, 0xfd01, 0, 0, 1, 0, 0, 0, 0);
+  uip_ds6_route_add(&addr, 64, &nexthops[2]);
+  uip_ip6addr(&addr, 0xfd01, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_route_add(&addr, 48, &nexthops[1]);
+
+  return uip_ds6_route_num_routes() == size;
+}
+/*---------------------------------------------------------------------------*/
+/* The longest match, by exhaustive search of the routing table */
+static uip_ds6_route_t *
+reference_lookup(const uip_ipaddr_t *addr)
+{
+  uip_ds6_route_t *r;
+  uip_ds6_route_t *found = NULL;
+
+  for(r = uip_ds6_route_head(); r != NULL; r = uip_ds6_route_next(r)) {
+    if(uip_ipaddr_prefixcmp(addr, &r->ipaddr, r->length) &&
+       (found == NULL || r->length > found->length)) {
+      found = r;
+    }
+  }
+  return found;
+}
+/*---------------------------------------------------------------------------*/
+static int
+lookups_match(int size)
+{
+  uip_ipaddr_t addr;
+  int i;
+
+  for(i = 1; i <= size + 10; i++) {
+    /* Known hosts, and unknown ones that fall back to the /64 */
+    host_addr(&addr, i);
+    if(uip_ds6_route_lookup(&addr) != reference_lookup(&addr)) {
+      return 0;
+    }
+  }
+  for(i = 0; i < 4; i++) {
+    /* The /48 and its more specific /64, and no route at all */
+    uip_ip6addr(&addr, 0xfd01, 0, 0, i, 0, 0, 0, 1);
+    if(uip_ds6_route_lookup(&addr) != reference_lookup(&addr)) {
+      return 0;
+    }
+    uip_ip6addr(&addr, 0xfd02, 0, 0, i, 0, 0, 0, 1);
+    if(uip_ds6_route_lookup(&addr) != NULL) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench_lookup(int size)
+{
+  uip_ipaddr_t addr;
+  uint64_t start, elapsed, best;
+  int i, r, found;
+
+  check(build_table(size), "routing table built", size);
+  check(lookups_match(size), "longest match found", size);
+
+  found = 0;
+  best = UINT64_MAX;
+  for(r = 0; r < REPEATS; r++) {
+    start = now();
+    for(i = 0; i < LOOKUPS; i++) {
+      host_addr(&addr, 1 + (i * 7919) % (size - 3));
+      found += uip_ds6_route_lookup(&addr) != NULL;
+    }
+    elapsed = now() - start;
+    best = MIN(best, elapsed);
+  }
+
+  printf("route-lookup: %d routes, %lu " UNIT " per lookup\n",
+         size, (unsigned long)(best / LOOKUPS));
+  check(found == REPEATS * LOOKUPS, "host routes found", size);
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_removal(void)
+{
+  uip_ipaddr_t addr;
+  uip_ds6_route_t *r;
+  int size = sizes[0];
+
+  build_table(size);
+  host_addr(&addr, 1);
+  uip_ds6_route_rm(uip_ds6_route_lookup(&addr));
+  r = uip_ds6_route_lookup(&addr);
+  check(r != NULL && r->length == 64, "removed host falls back to prefix", size);
+  uip_ds6_route_rm(r);
+  check(uip_ds6_route_lookup(&addr) == NULL, "removed prefix", size);
+  host_addr(&addr, 2);
+  check(uip_ds6_route_lookup(&addr) != NULL &&
+        uip_ds6_route_num_routes() == size - 2, "other routes kept", size);
+  check(lookups_match(size), "longest match after removals", size);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(route_lookup_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  add_nexthops();
+
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    bench_lookup(sizes[i]);
+  }
+  test_removal();
+
+  printf("=check-me= DONE\n");
+  exit(failed);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Test of 6LoWPAN reassembly with interleaved fragment streams.
+ *         Several senders send fragmented packets at once, their
+ *         fragments shuffled and some retransmitted; a noisy sender
+ *         leaves packets incomplete. Checks that the packets of the
+ *         others are all reassembled, and the reassembly statistics.
+ */
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/sicslowpan.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define SENDERS 4
+#define NOISY SENDERS
+#define EMPTY (SENDERS + 1)
+#define ROUNDS 500
+#define NOISY_PACKETS 20
+/* The per-sender quota, half of the reassembly contexts */
+#define QUOTA 4
+
+/* A 400-byte packet: the first fragment carries 40 bytes of IPv6
+   header and 56 of payload, the others 96, 96, 96 and 16 */
+#define DATAGRAM_LEN 400
+#define FIRST_LEN 96
+#define CHUNK_LEN 96
+#define FRAGMENTS 5
+
+#define UIP_IP_BUF ((uint8_t *)&uip_buf[UIP_LLH_LEN])
+
+static int delivered;
+static int corrupt;
+static int failed;
+static struct etimer et;
+/*---------------------------------------------------------------------------*/
+PROCESS(sixlowpan_reass_process, "6LoWPAN reassembly test");
+AUTOSTART_PROCESSES(&sixlowpan_reass_process);
+/*---------------------------------------------------------------------------*/
+#if defined(__i386__) || defined(__x86_64__)
+#define UNIT "cycles"
+#define now() __builtin_ia32_rdtsc()
+#else
+#define UNIT "ns"
+static uint64_t
+now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+#endif
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr, int n)
+{
+  printf("=check-me= %s - %s (n=%d)\n", cond ? "SUCCEEDED" : "FAILED", descr, n);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The bytes of the packets. The version is zero, so that uIP drops
+   them once they have been reassembled. */
+static uint8_t
+datagram_byte(int id, uint16_t tag, int i)
+{
+  switch(i) {
+  case 0:
+    return 0;
+  case 1:
+    return id;
+  case 2:
+    return tag >> 8;
+  case 3:
+    return tag & 0xff;
+  default:
+    return id * 31 + tag * 7 + i;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+input_callback(void)
+{
+  int i, id;
+  uint16_t tag;
+
+  delivered++;
+  id = UIP_IP_BUF[1];
+  tag = (UIP_IP_BUF[2] << 8) | UIP_IP_BUF[3];
+  if(uip_len != DATAGRAM_LEN) {
+    corrupt++;
+    return;
+  }
+  for(i = 0; i < DATAGRAM_LEN; i++) {
+    if(UIP_IP_BUF[i] != datagram_byte(id, tag, i)) {
+      corrupt++;
+      return;
+    }
+  }
+}
+NETSTACK_SNIFFER(sniffer, input_callback, NULL);
+/*---------------------------------------------------------------------------*/
+/* Receive a fragment of len bytes at offset of a packet of size bytes */
+static void
+receive_frame(int id, uint16_t tag, int size, int offset, int len)
+{
+  linkaddr_t sender;
+  uint8_t *p;
+  int i;
+
+  packetbuf_clear();
+  p = packetbuf_dataptr();
+  if(offset == 0) {
+    *p++ = SICSLOWPAN_DISPATCH_FRAG1 | (size >> 8);
+    *p++ = size & 0xff;
+    *p++ = tag >> 8;
+    *p++ = tag & 0xff;
+    *p++ = SICSLOWPAN_DISPATCH_IPV6;
+  } else {
+    *p++ = SICSLOWPAN_DISPATCH_FRAGN | (size >> 8);
+    *p++ = size & 0xff;
+    *p++ = tag >> 8;
+    *p++ = tag & 0xff;
+    *p++ = offset >> 3;
+  }
+  for(i = 0; i < len; i++) {
+    *p++ = datagram_byte(id, tag, offset + i);
+  }
+  packetbuf_set_datalen(p - (uint8_t *)packetbuf_dataptr());
+
+  memset(&sender, 0, sizeof(sender));
+  sender.u8[0] = 0x02;
+  sender.u8[LINKADDR_SIZE - 1] = id + 1;
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &sender);
+
+  sicslowpan_driver.input();
+}
+/*---------------------------------------------------------------------------*/
+/* Receive fragment n of a packet */
+static void
+receive_fragment(int id, uint16_t tag, int n)
+{
+  int offset;
+
+  if(n == 0) {
+    receive_frame(id, tag, DATAGRAM_LEN, 0, FIRST_LEN);
+  } else {
+    offset = FIRST_LEN + (n - 1) * CHUNK_LEN;
+    receive_frame(id, tag, DATAGRAM_LEN, offset,
+                  MIN(CHUNK_LEN, DATAGRAM_LEN - offset));
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The fragments of a packet of each sender, in random order, with a
+   retransmission of the first fragment of each sender to arrive */
+static void
+receive_interleaved(uint16_t tag)
+{
+  struct { uint8_t id; uint8_t n; } order[SENDERS * (FRAGMENTS + 1)];
+  uint8_t retransmitted[SENDERS];
+  int i, j, count;
+
+  count = 0;
+  for(i = 0; i < SENDERS; i++) {
+    for(j = 0; j < FRAGMENTS; j++) {
+      order[count].id = i;
+      order[count].n = j;
+      count++;
+    }
+  }
+  for(i = count - 1; i > 0; i--) {
+    j = rand() % (i + 1);
+    order[count] = order[i];
+    order[i] = order[j];
+    order[j] = order[count];
+  }
+
+  memset(retransmitted, 0, sizeof(retransmitted));
+  for(i = 0; i < count; i++) {
+    receive_fragment(order[i].id, tag, order[i].n);
+    if(!retransmitted[order[i].id]) {
+      retransmitted[order[i].id] = 1;
+      receive_fragment(order[i].id, tag, order[i].n);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Packets of the noisy sender, with their last fragments lost */
+static void
+receive_incomplete(uint16_t first_tag, int packets)
+{
+  int i;
+
+  for(i = 0; i < packets; i++) {
+    receive_fragment(NOISY, first_tag + i, 0);
+    receive_fragment(NOISY, first_tag + i, 1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(sixlowpan_reass_process, ev, data)
+{
+  static struct sicslowpan_reass_stats before;
+  static uint64_t start, elapsed;
+  static int i;
+
+  PROCESS_BEGIN();
+
+  srand(1);
+  sicslowpan_driver.init();
+  netstack_sniffer_add(&sniffer);
+
+  /* Interleaved, out of order and retransmitted fragments */
+  start = now();
+  for(i = 0; i < ROUNDS; i++) {
+    receive_interleaved(i);
+  }
+  elapsed = now() - start;
+  printf("sixlowpan-reass: %d senders, %lu %s per fragment\n", SENDERS,
+         (unsigned long)(elapsed / (ROUNDS * SENDERS * (FRAGMENTS + 1))), UNIT);
+  check(delivered == ROUNDS * SENDERS && corrupt == 0,
+        "interleaved packets reassembled", delivered);
+  check(sicslowpan_reass_stats.reassembled == ROUNDS * SENDERS,
+        "reassembled counted", sicslowpan_reass_stats.reassembled);
+  check(sicslowpan_reass_stats.duplicates == ROUNDS * SENDERS,
+        "retransmissions ignored", sicslowpan_reass_stats.duplicates);
+
+  /* A noisy sender cannot take the contexts of the others */
+  receive_incomplete(1000, NOISY_PACKETS);
+  check(sicslowpan_reass_stats.evicted == NOISY_PACKETS - QUOTA,
+        "noisy sender evicts its own packets", sicslowpan_reass_stats.evicted);
+  delivered = 0;
+  for(i = 0; i < 10; i++) {
+    receive_interleaved(ROUNDS + i);
+  }
+  check(delivered == 10 * SENDERS && corrupt == 0,
+        "others reassembled next to noisy sender", delivered);
+
+  /* A later fragment cannot evict: it does not show the sender has
+     moved on */
+  receive_fragment(NOISY, 2000, 1);
+  check(sicslowpan_reass_stats.no_context == 1,
+        "no context beyond quota", sicslowpan_reass_stats.no_context);
+
+  /* Hopeless packets are dropped early */
+  receive_frame(0, 3000, 2000, 0, FIRST_LEN);
+  receive_frame(0, 3001, DATAGRAM_LEN, FIRST_LEN, 120);
+  check(sicslowpan_reass_stats.dropped == 2,
+        "hopeless packets dropped", sicslowpan_reass_stats.dropped);
+  delivered = 0;
+  receive_interleaved(ROUNDS + 10);
+  check(delivered == SENDERS && corrupt == 0,
+        "reassembly after drops", delivered);
+
+  /* The incomplete packets of the noisy sender time out */
+  etimer_set(&et, CLOCK_SECOND);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  before = sicslowpan_reass_stats;
+  delivered = 0;
+  receive_interleaved(ROUNDS + 11);
+  check(delivered == SENDERS, "reassembly after timeout", delivered);
+  check(sicslowpan_reass_stats.timeouts - before.timeouts == QUOTA,
+        "incomplete packets timed out",
+        sicslowpan_reass_stats.timeouts - before.timeouts);
+  receive_incomplete(4000, QUOTA);
+  check(sicslowpan_reass_stats.evicted == before.evicted,
+        "contexts freed by timeout",
+        sicslowpan_reass_stats.evicted - before.evicted);
+
+  /* A first fragment of an empty packet is hopeless. Its context must
+     not be left chained once it has been reused: the tags below all
+     hash to the same bucket with 8 contexts. */
+  before = sicslowpan_reass_stats;
+  receive_frame(EMPTY, 10, 0, 0, FIRST_LEN);
+  receive_frame(EMPTY, 18, 200, 0, FIRST_LEN);
+  receive_frame(EMPTY, 26, DATAGRAM_LEN, FIRST_LEN, CHUNK_LEN);
+  check(sicslowpan_reass_stats.dropped - before.dropped == 1,
+        "empty packet dropped", sicslowpan_reass_stats.dropped - before.dropped);
+  delivered = 0;
+  for(i = 0; i < FRAGMENTS; i++) {
+    receive_fragment(EMPTY, 34, i);
+  }
+  check(delivered == 1 && corrupt == 0, "reassembly after empty packet",
+        delivered);
+
+  printf("sixlowpan-reass: reassembled %u timeouts %u no_context %u "
+         "evicted %u dropped %u duplicates %u\n",
+         sicslowpan_reass_stats.reassembled, sicslowpan_reass_stats.timeouts,
+         sicslowpan_reass_stats.no_context, sicslowpan_reass_stats.evicted,
+         sicslowpan_reass_stats.dropped, sicslowpan_reass_stats.duplicates);
+
+  printf("=check-me= DONE\n");
+  exit(failed);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
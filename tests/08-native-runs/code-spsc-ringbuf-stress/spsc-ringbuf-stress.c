@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Stress test of the single-producer, single-consumer ring
+ *         buffer. A producer thread puts byte streams and records of
+ *         varying lengths in a small ring buffer while the Contiki
+ *         process gets them, and checks that everything comes out
+ *         complete and in order.
+ */
+
+#include "contiki.h"
+#include "lib/spsc-ringbuf.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define RING_SIZE 256
+#define STREAM_BYTES 20000000
+#define RECORDS 1000000
+#define MAX_RECORD_LEN 100
+
+static uint8_t ring_data[RING_SIZE];
+static struct spsc_ringbuf ring;
+static int failed;
+/*---------------------------------------------------------------------------*/
+PROCESS(spsc_ringbuf_process, "spsc ringbuf stress test");
+AUTOSTART_PROCESSES(&spsc_ringbuf_process);
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr, long n)
+{
+  printf("=check-me= %s - %s (n=%ld)\n", cond ? "SUCCEEDED" : "FAILED", descr, n);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The length and contents of record number seq */
+static int
+record_len(uint32_t seq)
+{
+  return sizeof(seq) + (seq * 7919) % (MAX_RECORD_LEN - sizeof(seq) + 1);
+}
+static void
+record_fill(uint32_t seq, uint8_t *buf, int len)
+{
+  int i;
+
+  memcpy(buf, &seq, sizeof(seq));
+  for(i = sizeof(seq); i < len; i++) {
+    buf[i] = seq + i;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void *
+stream_producer(void *arg)
+{
+  uint8_t chunk[64];
+  uint32_t sent = 0;
+  int i, len, chunk_len = 1;
+
+  while(sent < STREAM_BYTES) {
+    chunk_len = chunk_len % sizeof(chunk) + 1;
+    len = MIN(chunk_len, STREAM_BYTES - sent);
+    for(i = 0; i < len; i++) {
+      chunk[i] = (sent + i) * 31;
+    }
+    for(i = 0; i < len;) {
+      int n = spsc_ringbuf_put(&ring, chunk + i, len - i);
+      if(n == 0) {
+        sched_yield();
+      }
+      i += n;
+    }
+    sent += len;
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void *
+record_producer(void *arg)
+{
+  uint8_t buf[MAX_RECORD_LEN];
+  uint32_t seq;
+  int len;
+
+  for(seq = 0; seq < RECORDS; seq++) {
+    len = record_len(seq);
+    record_fill(seq, buf, len);
+    while(!spsc_ringbuf_put_record(&ring, buf, len)) {
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_stream(void)
+{
+  pthread_t producer;
+  uint8_t chunk[48];
+  uint32_t received = 0;
+  int i, n, chunk_len = 1, ok = 1;
+  uint64_t start = now_ns();
+
+  spsc_ringbuf_init(&ring, ring_data, RING_SIZE);
+  pthread_create(&producer, NULL, stream_producer, NULL);
+  while(received < STREAM_BYTES) {
+    chunk_len = chunk_len % sizeof(chunk) + 1;
+    n = spsc_ringbuf_get(&ring, chunk, chunk_len);
+    if(n == 0) {
+      sched_yield();
+    }
+    for(i = 0; i < n; i++) {
+      ok &= chunk[i] == (uint8_t)((received + i) * 31);
+    }
+    received += n;
+  }
+  pthread_join(producer, NULL);
+
+  printf("spsc-ringbuf: %d-bit pointers, %u bytes streamed in %lu ms\n",
+         SPSC_RINGBUF_32BIT ? 32 : 16, (unsigned)received,
+         (unsigned long)((now_ns() - start) / 1000000));
+  check(ok, "bytes in order", received);
+  check(spsc_ringbuf_elements(&ring) == 0 &&
+        spsc_ringbuf_get(&ring, chunk, sizeof(chunk)) == 0, "stream drained", 0);
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_records(void)
+{
+  pthread_t producer;
+  uint8_t buf[MAX_RECORD_LEN];
+  uint8_t expected[MAX_RECORD_LEN];
+  uint32_t seq = 0;
+  int len, peeked, ok = 1;
+  uint64_t start = now_ns();
+
+  spsc_ringbuf_init(&ring, ring_data, RING_SIZE);
+  pthread_create(&producer, NULL, record_producer, NULL);
+  while(seq < RECORDS) {
+    peeked = spsc_ringbuf_peek_record(&ring);
+    len = spsc_ringbuf_get_record(&ring, buf, sizeof(buf));
+    if(len < 0) {
+      sched_yield();
+      continue;
+    }
+    record_fill(seq, expected, record_len(seq));
+    ok &= peeked == len && len == record_len(seq) &&
+      memcmp(buf, expected, len) == 0;
+    seq++;
+  }
+  pthread_join(producer, NULL);
+
+  printf("spsc-ringbuf: %d-bit pointers, %u records in %lu ms\n",
+         SPSC_RINGBUF_32BIT ? 32 : 16, (unsigned)seq,
+         (unsigned long)((now_ns() - start) / 1000000));
+  check(ok, "records complete and in order", seq);
+  check(spsc_ringbuf_get_record(&ring, buf, sizeof(buf)) == -1,
+        "records drained", 0);
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_limits(void)
+{
+  uint8_t buf[RING_SIZE];
+  int ok;
+
+  memset(buf, 0x5a, sizeof(buf));
+  spsc_ringbuf_init(&ring, ring_data, RING_SIZE);
+
+  /* A record is put whole or not at all */
+  ok = !spsc_ringbuf_put_record(&ring, buf, RING_SIZE - SPSC_RINGBUF_RECORD_HDR_LEN + 1);
+  ok &= spsc_ringbuf_elements(&ring) == 0;
+  ok &= spsc_ringbuf_put_record(&ring, buf, RING_SIZE - SPSC_RINGBUF_RECORD_HDR_LEN);
+  ok &= spsc_ringbuf_free(&ring) == 0;
+  ok &= !spsc_ringbuf_put_record(&ring, buf, 0);
+  /* A record longer than the buffer is truncated, and removed whole */
+  ok &= spsc_ringbuf_get_record(&ring, buf, 10) == RING_SIZE - SPSC_RINGBUF_RECORD_HDR_LEN;
+  ok &= spsc_ringbuf_elements(&ring) == 0;
+  /* Bulk put stops when the buffer is full */
+  ok &= spsc_ringbuf_put(&ring, buf, RING_SIZE + 10) == RING_SIZE;
+  ok &= spsc_ringbuf_get(&ring, buf, RING_SIZE + 10) == RING_SIZE;
+  check(ok, "full and empty buffer", RING_SIZE);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(spsc_ringbuf_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  test_limits();
+  test_stream();
+  test_records();
+
+  printf("=check-me= DONE\n");
+  exit(failed);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark of downward forwarding at a non-storing RPL root.
+ *         A tree of nodes is registered in the source routing graph,
+ *         as DAOs would, and packets to random nodes go through the
+ *         root's extension header processing, which looks the
+ *         destination up and inserts a source routing header, or
+ *         uses the one it cached. Reports the CPU cycles (or
+ *         nanoseconds) per packet for several network sizes, and checks
+ *         the inserted routes, also after topology changes.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-sr.h"
+#include "net/routing/routing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define PACKETS 20000
+#define REPEATS 3
+/* Every node has up to this many children */
+#define FANOUT 4
+#define PAYLOAD_LEN 20
+
+#define UIP_IP_BUF ((struct uip_ip_hdr *)&uip_buf[UIP_LLH_LEN])
+
+static const int sizes[] = { 16, 128, 1024 };
+static uip_ipaddr_t root_addr;
+static int failed;
+/*---------------------------------------------------------------------------*/
+PROCESS(sr_forwarding_process, "Source routing forwarding benchmark");
+AUTOSTART_PROCESSES(&sr_forwarding_process);
+/*---------------------------------------------------------------------------*/
+#if defined(__i386__) || defined(__x86_64__)
+#define UNIT "cycles"
+#define now() __builtin_ia32_rdtsc()
+#else
+#define UNIT "ns"
+static uint64_t
+now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+#endif
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr, int n)
+{
+  printf("=check-me= %s - %s (n=%d)\n", cond ? "SUCCEEDED" : "FAILED", descr, n);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Node 0 is the root, and the parent of node i is node (i - 1) / FANOUT */
+static void
+node_addr(uip_ipaddr_t *addr, int i)
+{
+  if(i == 0) {
+    uip_ipaddr_copy(addr, &root_addr);
+  } else {
+    memcpy(addr, &root_addr, 8);
+    memset(&addr->u8[8], 0, 8);
+    addr->u8[8] = 0x02;
+    addr->u8[14] = i >> 8;
+    addr->u8[15] = i & 0xff;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+build_network(int size)
+{
+  uip_ipaddr_t child, parent;
+  int i;
+
+  uip_sr_free_all();
+  for(i = 1; i <= size; i++) {
+    node_addr(&child, i);
+    node_addr(&parent, (i - 1) / FANOUT);
+    if(uip_sr_update_node(NULL, &child, &parent, 3600) == NULL) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Put a UDP packet from the root to node i in uip_buf */
+static void
+build_packet(int i)
+{
+  memset(uip_buf, 0, UIP_IPH_LEN + UIP_UDPH_LEN + PAYLOAD_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &root_addr);
+  node_addr(&UIP_IP_BUF->destipaddr, i);
+  uip_len = UIP_IPH_LEN + UIP_UDPH_LEN + PAYLOAD_LEN;
+  UIP_IP_BUF->len[0] = (uip_len - UIP_IPH_LEN) >> 8;
+  UIP_IP_BUF->len[1] = (uip_len - UIP_IPH_LEN) & 0xff;
+  uip_ext_len = 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Check that the packet in uip_buf goes to node i through a source route */
+static int
+routed_to(int i)
+{
+  uip_ipaddr_t first_hop;
+  int hop, hops;
+
+  for(hop = i, hops = 0; (hop - 1) / FANOUT != 0; hop = (hop - 1) / FANOUT) {
+    hops++;
+  }
+  node_addr(&first_hop, hop);
+  return UIP_IP_BUF->proto == UIP_PROTO_ROUTING &&
+    uip_ipaddr_cmp(&UIP_IP_BUF->destipaddr, &first_hop) &&
+    ((uint8_t *)UIP_IP_BUF)[UIP_IPH_LEN + 3] == hops;
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench_forwarding(int size)
+{
+  uint64_t start, elapsed, best;
+  int i, r, dest, ok;
+
+  check(build_network(size), "network built", size);
+
+  ok = 1;
+  best = UINT64_MAX;
+  for(r = 0; r < REPEATS; r++) {
+    start = now();
+    for(i = 0; i < PACKETS; i++) {
+      dest = 1 + (i * 7919) % size;
+      build_packet(dest);
+      ok &= NETSTACK_ROUTING.ext_header_update();
+    }
+    elapsed = now() - start;
+    best = MIN(best, elapsed);
+  }
+  for(i = 0; i < 100; i++) {
+    dest = 1 + (i * 7919) % size;
+    build_packet(dest);
+    ok &= NETSTACK_ROUTING.ext_header_update() && routed_to(dest);
+  }
+
+  printf("sr-forwarding: %d nodes, %lu " UNIT " per downward packet\n",
+         size, (unsigned long)(best / PACKETS));
+  check(ok, "source routes inserted", size);
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_expiration(void)
+{
+  uip_ipaddr_t leaf, parent;
+  int size = sizes[0];
+  int leaf_id = size;
+
+  build_network(size);
+  node_addr(&leaf, leaf_id);
+  node_addr(&parent, (leaf_id - 1) / FANOUT);
+  uip_sr_expire_parent(NULL, &leaf, &parent);
+  uip_sr_periodic(UIP_SR_REMOVAL_DELAY);
+  uip_sr_periodic(1);
+  /* The root is in the graph too */
+  check(uip_sr_get_node(NULL, &leaf) == NULL &&
+        uip_sr_num_nodes() == size, "expired node removed", size);
+  node_addr(&leaf, leaf_id - 1);
+  check(uip_sr_get_node(NULL, &leaf) != NULL, "other nodes kept", size);
+  check(uip_sr_get_node(NULL, NULL) == NULL, "no node for no address", 0);
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_reparenting(void)
+{
+  uip_ipaddr_t leaf, parent;
+  int size = sizes[0];
+  int leaf_id = size;
+  int new_parent_id = 1;
+
+  build_network(size);
+  build_packet(leaf_id);
+  NETSTACK_ROUTING.ext_header_update();
+  check(routed_to(leaf_id), "route before reparenting", leaf_id);
+
+  /* A DAO refresh with the same parent keeps the route */
+  node_addr(&leaf, leaf_id);
+  node_addr(&parent, (leaf_id - 1) / FANOUT);
+  uip_sr_update_node(NULL, &leaf, &parent, 3600);
+  build_packet(leaf_id);
+  NETSTACK_ROUTING.ext_header_update();
+  check(routed_to(leaf_id), "route after refresh", leaf_id);
+
+  /* The route of the leaf now goes through node 1, its first hop */
+  node_addr(&parent, new_parent_id);
+  uip_sr_update_node(NULL, &leaf, &parent, 3600);
+  build_packet(leaf_id);
+  NETSTACK_ROUTING.ext_header_update();
+  check(uip_ipaddr_cmp(&UIP_IP_BUF->destipaddr, &parent) &&
+        ((uint8_t *)UIP_IP_BUF)[UIP_IPH_LEN + 3] == 1,
+        "route after reparenting", leaf_id);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(sr_forwarding_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  NETSTACK_ROUTING.root_start();
+  check(NETSTACK_ROUTING.get_root_ipaddr(&root_addr), "root started", 0);
+
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    bench_forwarding(sizes[i]);
+  }
+  test_reparenting();
+  test_expiration();
+
+  printf("=check-me= DONE\n");
+  exit(failed);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
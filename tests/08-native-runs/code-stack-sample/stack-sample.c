@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Test of stack usage measurements. Measurements are started at
+ *         the bottom of nested calls, each frame of which holds data
+ *         that restoring the fill pattern must not clobber, and must
+ *         find the depth of the calls made since they started.
+ */
+
+#include "contiki.h"
+#include "sys/stack-check.h"
+#include "sys/int-master.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ucontext.h>
+/*---------------------------------------------------------------------------*/
+#define FRAME_SIZE 64
+
+/* The stack of the measured code */
+uint8_t sample_stack[STACK_SAMPLE_SIZE] __asm__("_stack") CC_ALIGN(16);
+
+static ucontext_t main_context, sample_context;
+static int failed;
+/*---------------------------------------------------------------------------*/
+PROCESS(stack_sample_process, "Stack sample test");
+AUTOSTART_PROCESSES(&stack_sample_process);
+/*---------------------------------------------------------------------------*/
+static void
+check(int cond, const char *descr, int n)
+{
+  printf("=check-me= %s - %s (n=%d)\n", cond ? "SUCCEEDED" : "FAILED", descr, n);
+  if(!cond) {
+    failed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+do_nothing(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Start a measurement right below a frame holding data, and check that
+   a second one is refused and that interrupts are enabled again */
+static CC_NO_INLINE int
+begin_below_data(void)
+{
+  volatile uint8_t data[FRAME_SIZE];
+  int i, ok;
+
+  for(i = 0; i < FRAME_SIZE; i++) {
+    data[i] = i;
+  }
+  ok = stack_check_sample_begin() && !stack_check_sample_begin() &&
+    int_master_is_enabled();
+  for(i = 0; i < FRAME_SIZE; i++) {
+    if(data[i] != i) {
+      ok = 0;
+    }
+  }
+  return ok;
+}
+/*---------------------------------------------------------------------------*/
+/* Calls nested depth deep, each frame holding data, with at_bottom
+   called from the deepest. Returns zero if the data was clobbered or
+   at_bottom returned zero. */
+static CC_NO_INLINE int
+nested(int depth, int (*at_bottom)(void))
+{
+  volatile uint8_t data[FRAME_SIZE];
+  int i, ok;
+
+  for(i = 0; i < FRAME_SIZE; i++) {
+    data[i] = depth + i;
+  }
+  ok = depth > 0 ? nested(depth - 1, at_bottom) : at_bottom();
+  for(i = 0; i < FRAME_SIZE; i++) {
+    if(data[i] != (uint8_t)(depth + i)) {
+      ok = 0;
+    }
+  }
+  return ok;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+measure(int depth)
+{
+  stack_check_sample_begin();
+  nested(depth, do_nothing);
+  return stack_check_sample_end(NULL);
+}
+/*---------------------------------------------------------------------------*/
+/* Runs on the sample stack */
+static void
+sampled_main(void)
+{
+  static uint16_t u5, u10, u40, u, peak;
+  static int ok;
+
+  stack_check_init();
+  int_master_enable();
+
+  /* Each measurement finds the depth reached since it started, deeper
+     or not than the previous ones */
+  u10 = measure(10);
+  u40 = measure(40);
+  u5 = measure(5);
+  check(u40 - u10 >= 30 * FRAME_SIZE, "deeper calls measured", u40 - u10);
+  check(u5 < u10, "fill pattern restored", u10 - u5);
+  check(stack_check_get_usage() >= u40, "maximal usage kept",
+        stack_check_get_usage());
+
+  /* Measurements started at the bottom of nested calls */
+  ok = nested(20, begin_below_data);
+  u = stack_check_sample_end(&peak);
+  check(ok, "frames intact after begin in nested calls", 20);
+  check(u >= 20 * FRAME_SIZE && peak == u, "usage of nested calls", u);
+  ok = nested(20, begin_below_data);
+  nested(30, do_nothing);
+  u = stack_check_sample_end(&peak);
+  check(ok && u >= 30 * FRAME_SIZE && u < u40, "calls after nested begin", u);
+  check(stack_check_sample_begin(), "measurement after end", 1);
+  stack_check_sample_end(NULL);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(stack_sample_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  check(stack_check_get_reserved_size() == STACK_SAMPLE_SIZE,
+        "reserved size", stack_check_get_reserved_size());
+
+  getcontext(&sample_context);
+  sample_context.uc_stack.ss_sp = sample_stack;
+  sample_context.uc_stack.ss_size = sizeof(sample_stack);
+  sample_context.uc_link = &main_context;
+  makecontext(&sample_context, sampled_main, 0);
+  swapcontext(&main_context, &sample_context);
+
+  printf("=check-me= DONE\n");
+  exit(failed);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/